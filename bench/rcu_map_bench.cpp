@@ -0,0 +1,95 @@
+/*
+ * Read-mostly throughput: RcuHashMap against a mutex-wrapped and a shared_mutex-wrapped HashMap.
+ *
+ * Every thread performs a mix of 95% lookups and 5% inserts/updates over a fixed key range.
+ * Usage: rcu_map_bench [threads] [operations per thread]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+#include "../container/rcu_hash_map.hpp"
+#include "../container/unordered_map.hpp"
+
+namespace {
+
+constexpr int kKeys = 100000;
+constexpr int kWritePercent = 5;
+
+/// HashMap guarded by one lock; Lock is std::mutex or std::shared_mutex.
+template<typename Lock>
+class LockedMap {
+    mutable Lock mtx;
+    mgc::HashMap<int, long> map;
+public:
+    void insert(int k, long v) {
+        std::unique_lock lock(mtx);
+        map.insert_or_assign(k, v);
+    }
+    bool contains(int k) const {
+        if constexpr (std::is_same_v<Lock, std::shared_mutex>) {
+            std::shared_lock lock(mtx);
+            return map.contains(k);
+        } else {
+            std::unique_lock lock(mtx);
+            return map.contains(k);
+        }
+    }
+};
+
+template<typename Map>
+double run(Map &map, int threads, long ops) {
+    for (int k = 0; k < kKeys; k += 2)
+        map.insert(k, k);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    std::vector<long> found(static_cast<size_t>(threads));
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&map, &found, t, ops] {
+            std::mt19937 rng(static_cast<unsigned>(t));
+            std::uniform_int_distribution<int> key(0, kKeys - 1), pct(0, 99);
+            long hits = 0;
+            for (long i = 0; i < ops; ++i) {
+                int k = key(rng);
+                if (pct(rng) < kWritePercent)
+                    map.insert(k, i);
+                else
+                    hits += map.contains(k);
+            }
+            found[static_cast<size_t>(t)] = hits;
+        });
+    }
+    for (auto &w : workers)
+        w.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(threads) * static_cast<double>(ops) / elapsed.count() / 1e6;
+}
+
+}
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    long ops = argc > 2 ? std::atol(argv[2]) : 1000000;
+    if (threads < 1)
+        threads = 1;
+
+    std::printf("%d threads, %ld ops/thread, %d%% writes\n", threads, ops, kWritePercent);
+    {
+        LockedMap<std::mutex> map;
+        std::printf("HashMap + std::mutex        %8.2f Mops/s\n", run(map, threads, ops));
+    }
+    {
+        LockedMap<std::shared_mutex> map;
+        std::printf("HashMap + std::shared_mutex %8.2f Mops/s\n", run(map, threads, ops));
+    }
+    {
+        mgc::RcuHashMap<int, long> map;
+        std::printf("RcuHashMap                  %8.2f Mops/s\n", run(map, threads, ops));
+    }
+    return 0;
+}
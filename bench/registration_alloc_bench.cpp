@@ -0,0 +1,165 @@
+/*
+ * Heap allocations per product registration.
+ *
+ * Counts calls to the global operator new while products are created and registered:
+ * the baseline construction path (a copy of the original product classes, whose
+ * constructors take std::string by value, built as a temporary and copied into
+ * std::make_shared), the single-allocation make_product(), make_product() into an arena,
+ * and warehouse::register_product() with and without reserve() and an arena. Firm,
+ * country and type strings are interned before counting, since each distinct value is
+ * stored only once per process. The firm name is longer than the small-string buffer.
+ * Usage: registration_alloc_bench [products] [name length]
+ */
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+#include "../logic/warehouse.hpp"
+
+namespace {
+
+namespace baseline {
+
+/// The original product: owns const std::string copies of every field.
+class product {
+protected:
+    size_t quantity;
+    size_t cost;
+    const std::string name;
+    const std::string firm;
+    const std::string country;
+    const std::string type;
+
+public:
+    product(std::string tp, size_t q, size_t c, std::string &n, std::string &f, std::string &cn)
+        : quantity(q), cost(c), name(n), firm(f), country(cn), type(tp) {}
+    virtual ~product() = default;
+    virtual size_t sell(size_t amount) = 0;
+};
+
+/// The original retail_product, with its by-value string parameters.
+class retail_product : public product {
+    size_t allowance;
+
+public:
+    retail_product(size_t q, size_t c, std::string n, std::string f, std::string cn, size_t a)
+        : product("retail", q, c, n, f, cn), allowance(a) {}
+    size_t sell(size_t num) override { quantity -= num; return num * cost * allowance / 100; }
+};
+
+} // namespace baseline
+
+std::atomic<size_t> allocations{0};
+
+void* counted_new(std::size_t n, std::size_t align = alignof(std::max_align_t)) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    n = (std::max<std::size_t>(n, 1) + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, n))
+        return p;
+    throw std::bad_alloc();
+}
+
+/// Runs @p f and returns the number of global allocations it made.
+template<typename F>
+size_t count_allocations(F &&f) {
+    size_t before = allocations.load(std::memory_order_relaxed);
+    f();
+    return allocations.load(std::memory_order_relaxed) - before;
+}
+
+} // namespace
+
+void* operator new(std::size_t n) { return counted_new(n); }
+void* operator new[](std::size_t n) { return counted_new(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+// std::pmr::new_delete_resource() allocates through the aligned forms.
+void* operator new(std::size_t n, std::align_val_t al) { return counted_new(n, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t n, std::align_val_t al) { return counted_new(n, static_cast<std::size_t>(al)); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+int main(int argc, char** argv) {
+    const size_t products = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const size_t name_length = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 32;
+
+    std::vector<mgw::product_components> components;
+    std::vector<std::string> ciphers;
+    components.reserve(products);
+    ciphers.reserve(products);
+    for (size_t i = 0; i < products; ++i) {
+        std::string name = "Item " + std::to_string(i);
+        name.resize(std::max(name.size(), name_length), '.');
+        components.push_back({10, 100, 5, std::move(name), "ACME Corporation", "United States", "retail"});
+        ciphers.push_back("C" + std::to_string(i));
+    }
+    for (const char* s : {"ACME Corporation", "United States", "retail"})
+        mgw::product::intern(s);
+
+    auto report = [products](const char* label, size_t count) {
+        std::printf("%-46s %10zu allocations  %6.2f per product\n", label, count,
+                    static_cast<double>(count) / static_cast<double>(products));
+    };
+
+    std::printf("%zu products, names of %zu characters\n", products, name_length);
+    {
+        std::vector<std::shared_ptr<baseline::product>> out;
+        out.reserve(products);
+        report("baseline: by-value strings + make_shared copy", count_allocations([&] {
+            for (const auto &pc : components)
+                out.push_back(std::make_shared<baseline::retail_product>(
+                    baseline::retail_product(pc.quantity, pc.cost, pc.name, pc.firm, pc.country, pc.num)));
+        }));
+    }
+    {
+        std::vector<std::shared_ptr<mgw::product>> out;
+        out.reserve(products);
+        report("make_product", count_allocations([&] {
+            for (const auto &pc : components)
+                out.push_back(mgw::make_product(pc));
+        }));
+    }
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        std::vector<std::shared_ptr<mgw::product>> out;
+        out.reserve(products);
+        report("make_product into an arena", count_allocations([&] {
+            for (const auto &pc : components)
+                out.push_back(mgw::make_product(pc, &arena));
+        }));
+    }
+    {
+        mgw::warehouse wh;
+        report("register_product", count_allocations([&] {
+            for (size_t i = 0; i < products; ++i)
+                wh.register_product(ciphers[i], components[i]);
+        }));
+    }
+    {
+        mgw::warehouse wh;
+        wh.reserve(products);
+        report("register_product after reserve", count_allocations([&] {
+            for (size_t i = 0; i < products; ++i)
+                wh.register_product(ciphers[i], components[i]);
+        }));
+    }
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        mgw::warehouse wh(&arena);
+        wh.reserve(products);
+        report("register_product after reserve, arena", count_allocations([&] {
+            for (size_t i = 0; i < products; ++i)
+                wh.register_product(ciphers[i], components[i]);
+        }));
+    }
+}
@@ -0,0 +1,95 @@
+/*
+ * Multi-threaded sell throughput: concurrent_warehouse against a warehouse behind one mutex.
+ *
+ * Every thread sells single units of random products from a catalog stocked so that it
+ * never runs out. Runs 1, 2, 4, ... up to the given number of threads and prints the
+ * speedup over one thread. Rows with more threads than hardware threads are marked, as
+ * they time-share cores and cannot show scaling.
+ * Usage: warehouse_bench [max threads] [sales per thread]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../logic/concurrent_warehouse.hpp"
+#include "../logic/warehouse.hpp"
+
+namespace {
+
+constexpr int kProducts = 100000;
+
+/// warehouse guarded by one lock.
+class LockedWarehouse {
+    std::mutex mtx;
+    mgw::warehouse wh;
+public:
+    void register_product(std::string_view cipher, const mgw::product_components &pr) {
+        std::lock_guard lock(mtx);
+        wh.register_product(cipher, pr);
+    }
+    size_t sell_product(std::string_view cipher, size_t num) {
+        std::lock_guard lock(mtx);
+        return wh.sell_product(cipher, num);
+    }
+};
+
+template<typename Warehouse>
+double run(const std::vector<std::string> &ciphers, int threads, long sales) {
+    Warehouse wh;
+    mgw::product_components pc{static_cast<size_t>(threads) * static_cast<size_t>(sales), 100, 10,
+                               "Item", "ACME", "USA", "retail"};
+    for (const std::string &c : ciphers)
+        wh.register_product(c, pc);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    std::vector<size_t> revenue(static_cast<size_t>(threads));
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&wh, &ciphers, &revenue, t, sales] {
+            std::mt19937 rng(static_cast<unsigned>(t));
+            std::uniform_int_distribution<size_t> pick(0, ciphers.size() - 1);
+            size_t total = 0;
+            for (long i = 0; i < sales; ++i)
+                total += wh.sell_product(ciphers[pick(rng)], 1);
+            revenue[static_cast<size_t>(t)] = total;
+        });
+    }
+    for (auto &w : workers)
+        w.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(threads) * static_cast<double>(sales) / elapsed.count() / 1e6;
+}
+
+}
+
+int main(int argc, char** argv) {
+    int max_threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    long sales = argc > 2 ? std::atol(argv[2]) : 1000000;
+    if (max_threads < 1)
+        max_threads = 1;
+
+    std::vector<std::string> ciphers;
+    for (int i = 0; i < kProducts; ++i)
+        ciphers.push_back("C-" + std::to_string(i));
+
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+    std::printf("%d products, %ld sales/thread, %d hardware threads\n", kProducts, sales, cores);
+    std::printf("threads  concurrent_warehouse       warehouse + std::mutex\n");
+    double base_concurrent = 0, base_locked = 0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double concurrent = run<mgw::concurrent_warehouse>(ciphers, threads, sales);
+        double locked = run<LockedWarehouse>(ciphers, threads, sales);
+        if (threads == 1) {
+            base_concurrent = concurrent;
+            base_locked = locked;
+        }
+        std::printf("%7d  %8.2f Mops/s (x%5.2f)  %8.2f Mops/s (x%5.2f)%s\n", threads,
+                    concurrent, concurrent / base_concurrent, locked, locked / base_locked,
+                    cores > 0 && threads > cores ? "  oversubscribed" : "");
+    }
+    return 0;
+}
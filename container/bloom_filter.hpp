@@ -0,0 +1,135 @@
+#ifndef BLOOM_FILTER_HPP_
+#define BLOOM_FILTER_HPP_
+
+#include <algorithm>    // for std::clamp, std::max, std::fill
+#include <bit>          // for std::bit_ceil
+#include <cmath>        // for std::log, std::ceil, std::lround
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint32_t, uint64_t
+#include <stdexcept>    // for std::invalid_argument
+#include <vector>       // for std::vector
+#include "hash.hpp"
+
+namespace mgc {
+
+/**
+ * @brief A blocked Bloom filter over precomputed hash values.
+ *
+ * Answers "definitely absent" or "possibly present" for a hash. Every key sets all of
+ * its bits inside one 64-byte block, so a query reads a single cache line. A blocked
+ * filter has a slightly higher false-positive rate than a classic one with the same
+ * memory, but each query touches one line instead of k.
+ *
+ * The filter stores hashes, not keys, so the caller must hash keys the same way for
+ * insert and may_contain. Bits cannot be cleared one key at a time. To forget keys, clear
+ * the filter and insert the remaining keys again. The false-positive rate holds up to
+ * capacity() inserted hashes and grows beyond it.
+ */
+class BloomFilter {
+    /**
+     * @brief One cache line of filter bits.
+     */
+    struct alignas(64) Block {
+        uint64_t words[8] = {}; ///< 512 bits.
+    };
+
+    static constexpr size_t kBlockBits = 512;
+
+    std::vector<Block> blocks; ///< Bit blocks; the count is a power of two.
+    size_t mask = 0;           ///< blocks.size() - 1.
+    unsigned hashes = 1;       ///< Number of bits set per key.
+    size_t expected = 0;       ///< Number of keys the filter was sized for.
+    size_t inserted = 0;       ///< Number of insert() calls since the last clear().
+
+    /**
+     * @brief The block and bit sequence selected by one hash.
+     *
+     * Bit i of the key is (x + i * step) mod 512 within the block; an odd step keeps the
+     * first 512 positions distinct.
+     */
+    struct Probe {
+        size_t block;  ///< Index of the block holding every bit of the key.
+        uint32_t x;    ///< Position of the first bit.
+        uint32_t step; ///< Distance between consecutive bits; odd.
+    };
+
+    Probe probe(size_t hash) const {
+        uint64_t g = detail::mul_fold(hash, 0x9E3779B97F4A7C15ull);
+        return {static_cast<size_t>(g) & mask,
+                static_cast<uint32_t>(g >> 32),
+                static_cast<uint32_t>(detail::mul_fold(g, 0xC2B2AE3D27D4EB4Full)) | 1};
+    }
+
+public:
+    /**
+     * @brief Constructs a filter sized for a number of keys and a target false-positive rate.
+     *
+     * @param capacity Number of keys the filter should hold at the target rate.
+     * @param fp_rate  Target false-positive rate, in (0, 1) (default is 0.01).
+     * @throws std::invalid_argument if @p fp_rate is not in (0, 1).
+     */
+    explicit BloomFilter(size_t capacity = 0, double fp_rate = 0.01) : expected(capacity) {
+        if (!(fp_rate > 0.0 && fp_rate < 1.0))
+            throw std::invalid_argument("Error: False-positive rate must be in (0, 1)");
+        const double ln2 = std::log(2.0);
+        double bits_per_key = -std::log(fp_rate) / (ln2 * ln2);
+        hashes = static_cast<unsigned>(std::clamp(std::lround(bits_per_key * ln2), 1L, 16L));
+        double bits = std::ceil(static_cast<double>(std::max<size_t>(capacity, 1)) * bits_per_key);
+        size_t n = std::bit_ceil(std::max<size_t>(1, static_cast<size_t>(std::ceil(bits / kBlockBits))));
+        blocks.resize(n);
+        mask = n - 1;
+    }
+
+    /**
+     * @brief Adds a hash to the filter.
+     */
+    void insert(size_t hash) {
+        Probe p = probe(hash);
+        for (unsigned i = 0; i < hashes; ++i, p.x += p.step) {
+            uint32_t bit = p.x & (kBlockBits - 1);
+            blocks[p.block].words[bit >> 6] |= uint64_t(1) << (bit & 63);
+        }
+        ++inserted;
+    }
+
+    /**
+     * @brief Checks whether a hash may have been inserted.
+     *
+     * @return false if the hash was definitely never inserted since the last clear().
+     */
+    bool may_contain(size_t hash) const {
+        Probe p = probe(hash);
+        for (unsigned i = 0; i < hashes; ++i, p.x += p.step) {
+            uint32_t bit = p.x & (kBlockBits - 1);
+            if (!(blocks[p.block].words[bit >> 6] & (uint64_t(1) << (bit & 63))))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Removes every hash from the filter. The size is kept.
+     */
+    void clear() {
+        std::fill(blocks.begin(), blocks.end(), Block{});
+        inserted = 0;
+    }
+
+    /**
+     * @brief Returns the number of insert() calls since the last clear().
+     */
+    size_t size() const { return inserted; }
+
+    /**
+     * @brief Returns the number of keys the filter was sized for.
+     */
+    size_t capacity() const { return expected; }
+
+    /**
+     * @brief Returns the memory used by the filter bits, in bytes.
+     */
+    size_t memory() const { return blocks.size() * sizeof(Block); }
+};
+
+}
+#endif // BLOOM_FILTER_HPP_
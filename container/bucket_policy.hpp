@@ -0,0 +1,85 @@
+#ifndef BUCKET_POLICY_HPP_
+#define BUCKET_POLICY_HPP_
+
+#include <bit>          // for std::bit_ceil
+#include <cstddef>      // for size_t
+#include "hash.hpp"
+
+namespace mgc {
+
+/*
+ * Bucket policies map a hash value to a bucket index and decide which bucket counts
+ * a table may use. A policy provides three static functions:
+ *
+ *   round_capacity(n)   - smallest valid bucket count that is at least n;
+ *   next_capacity(cap)  - bucket count to grow to when the load factor is exceeded;
+ *   index(hash, cap)    - bucket of a hash value in a table of cap buckets.
+ */
+
+/**
+ * @brief Plain modulo indexing with any bucket count, growing to 2n+1.
+ *
+ * This is the historical HashMap behaviour. It costs an integer division per operation
+ * and relies on the hash having good low-order entropy relative to the bucket count.
+ */
+struct modulo_policy {
+    static size_t round_capacity(size_t n) { return n ? n : 1; }
+    static size_t next_capacity(size_t cap) { return cap * 2 + 1; }
+    static size_t index(size_t hash, size_t cap) { return hash % cap; }
+};
+
+/**
+ * @brief Modulo indexing with prime bucket counts.
+ *
+ * A prime modulus uses every bit of the hash, which tolerates weak hashes (e.g. ones with
+ * patterns in the low bits) at the price of the integer division.
+ */
+struct prime_modulo_policy {
+    static size_t round_capacity(size_t n) {
+        if (n <= 2)
+            return 2;
+        size_t p = n | 1;
+        while (!is_prime(p))
+            p += 2;
+        return p;
+    }
+    static size_t next_capacity(size_t cap) { return round_capacity(cap * 2 + 1); }
+    static size_t index(size_t hash, size_t cap) { return hash % cap; }
+
+private:
+    static bool is_prime(size_t n) {
+        for (size_t d = 3; d * d <= n; d += 2)
+            if (n % d == 0)
+                return false;
+        return true;
+    }
+};
+
+/**
+ * @brief Power-of-two bucket counts indexed with a bit mask.
+ *
+ * The hash is post-mixed first, because masking only keeps the low bits.
+ * Removes the division from the hot path entirely.
+ */
+struct pow2_mask_policy {
+    static size_t round_capacity(size_t n) { return std::bit_ceil(n ? n : 1); }
+    static size_t next_capacity(size_t cap) { return cap * 2; }
+    static size_t index(size_t hash, size_t cap) { return detail::mix_hash(hash) & (cap - 1); }
+};
+
+/**
+ * @brief Lemire's fast range reduction: maps a hash to [0, cap) with one multiply and shift.
+ *
+ * Works with any bucket count and uses the high bits of the product, so the hash is
+ * post-mixed to spread entropy into the high bits first.
+ */
+struct fastrange_policy {
+    static size_t round_capacity(size_t n) { return n ? n : 1; }
+    static size_t next_capacity(size_t cap) { return cap * 2; }
+    static size_t index(size_t hash, size_t cap) {
+        return static_cast<size_t>((static_cast<unsigned __int128>(detail::mix_hash(hash)) * cap) >> 64);
+    }
+};
+
+}
+#endif // BUCKET_POLICY_HPP_
@@ -0,0 +1,284 @@
+#ifndef CONCURRENT_HASH_MAP_HPP_
+#define CONCURRENT_HASH_MAP_HPP_
+
+#include <algorithm>    // for std::for_each
+#include <bit>          // for std::bit_ceil
+#include <execution>    // for std::execution::par
+#include <functional>   // for std::hash
+#include <memory>       // for std::unique_ptr
+#include <mutex>        // for std::unique_lock
+#include <numeric>      // for std::iota
+#include <optional>     // for std::optional
+#include <shared_mutex> // for std::shared_mutex, std::shared_lock
+#include <thread>       // for std::thread::hardware_concurrency
+#include <utility>      // for std::forward, std::move
+#include <vector>       // for std::vector
+#include "hash.hpp"
+#include "unordered_map.hpp"
+
+namespace mgc {
+
+/**
+ * @brief A thread-safe hash map that partitions its keys over independently locked shards.
+ *
+ * Every key belongs to exactly one shard, chosen from the high bits of its mixed hash.
+ * A shard is an ordinary single-threaded map guarded by a reader-writer lock, so
+ * operations on different shards never contend, and lookups on the same shard share the lock.
+ * Shards are cache-line aligned so that their locks do not false-share.
+ *
+ * Because elements may be modified or erased by other threads at any time, the map does
+ * not hand out iterators or references. Elements are read by copy (find) or accessed
+ * under the shard lock through callbacks (visit, for_each). Callbacks must not call back
+ * into the same map.
+ *
+ * @tparam Key      The key type.
+ * @tparam Value    The mapped value type.
+ * @tparam Hash     The hash function object type. Defaults to std::hash<Key>.
+ * @tparam Map      The per-shard map template, instantiated as Map<Key, Value, Hash>. Defaults to mgc::HashMap.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>,
+         template<typename...> class Map = HashMap>
+class ConcurrentHashMap {
+public:
+    /// The type of key-value pair stored in the map.
+    using value_type = std::pair<const Key, Value>;
+    /// The per-shard map type.
+    using shard_map = Map<Key, Value, Hash>;
+
+private:
+    static constexpr size_t kCacheLine = 64; ///< Alignment of each shard.
+
+    /**
+     * @brief One partition of the key space.
+     */
+    struct alignas(kCacheLine) Shard {
+        mutable std::shared_mutex mtx; ///< Guards map.
+        shard_map map;                 ///< Elements whose keys belong to this shard.
+    };
+
+    std::unique_ptr<Shard[]> shards; ///< Array of shards.
+    size_t shard_count;              ///< Number of shards (a power of two).
+    Hash hashFunc;                   ///< Hash function object used to pick a shard.
+
+    /**
+     * @brief Returns the shard responsible for a key.
+     *
+     * The inner maps index buckets with the raw hash, so the shard is taken from the
+     * upper half of the mixed hash to keep both choices independent.
+     */
+    template<typename K>
+    Shard& shard_for(const K &key) const {
+        size_t h = detail::mix_hash(hashFunc(key));
+        return shards[(h >> 32) & (shard_count - 1)];
+    }
+
+public:
+    /**
+     * @brief Constructs an empty map.
+     *
+     * @param shards_hint Requested number of shards, rounded up to a power of two.
+     *                    Defaults to four shards per hardware thread.
+     */
+    explicit ConcurrentHashMap(size_t shards_hint = 4 * std::max(1u, std::thread::hardware_concurrency()))
+        : shards(nullptr), shard_count(std::bit_ceil(shards_hint ? shards_hint : 1))
+    {
+        shards.reset(new Shard[shard_count]);
+    }
+
+    ConcurrentHashMap(const ConcurrentHashMap &) = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap &) = delete;
+
+    /**
+     * @brief Returns the number of shards.
+     */
+    size_t shards_count() const { return shard_count; }
+
+    /**
+     * @brief Returns the number of elements.
+     *
+     * Shards are counted one after another, so under concurrent modification the result is only a snapshot.
+     *
+     * @return The number of stored key-value pairs.
+     */
+    size_t size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < shard_count; ++i) {
+            std::shared_lock lock(shards[i].mtx);
+            total += shards[i].map.size();
+        }
+        return total;
+    }
+
+    /**
+     * @brief Removes every element.
+     */
+    void clear() {
+        for (size_t i = 0; i < shard_count; ++i) {
+            std::unique_lock lock(shards[i].mtx);
+            shards[i].map.clear();
+        }
+    }
+
+    /**
+     * @brief Inserts a key-value pair, or assigns the value if the key already exists.
+     *
+     * @param key   The key to insert.
+     * @param value The value associated with the key.
+     * @return true if a new element was inserted.
+     */
+    bool insert(const Key &key, const Value &value) {
+        Shard &s = shard_for(key);
+        std::unique_lock lock(s.mtx);
+        return s.map.insert_or_assign(key, value).second;
+    }
+
+    /**
+     * @brief Inserts an element with the value constructed from @p args, unless the key already exists.
+     *
+     * @param key  The key to insert (Key, or a compatible type if Hash is transparent).
+     * @param args Arguments forwarded to the Value constructor.
+     * @return true if a new element was inserted.
+     */
+    template<typename K, typename... Args>
+    bool try_emplace(K &&key, Args&&... args) {
+        Shard &s = shard_for(key);
+        std::unique_lock lock(s.mtx);
+        return s.map.try_emplace(std::forward<K>(key), std::forward<Args>(args)...).second;
+    }
+
+    /**
+     * @brief Inserts a new element, or calls @p f on the existing one, under one lock acquisition.
+     *
+     * @param key  The key to insert (Key, or a compatible type if Hash is transparent).
+     * @param f    Callback invoked as f(value_type&) if the key already exists.
+     * @param args Arguments forwarded to the Value constructor of a new element.
+     * @return true if a new element was inserted.
+     */
+    template<typename K, typename F, typename... Args>
+    bool try_emplace_or_visit(K &&key, F &&f, Args&&... args) {
+        Shard &s = shard_for(key);
+        std::unique_lock lock(s.mtx);
+        auto [it, inserted] = s.map.try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+        if (!inserted)
+            f(*it);
+        return inserted;
+    }
+
+    /**
+     * @brief Erases the element with the given key.
+     *
+     * @param key The key of the element to erase.
+     * @return true if an element was erased.
+     */
+    template<typename K>
+    bool erase(const K &key) {
+        Shard &s = shard_for(key);
+        std::unique_lock lock(s.mtx);
+        size_t before = s.map.size();
+        s.map.erase(key);
+        return s.map.size() != before;
+    }
+
+    /**
+     * @brief Returns a copy of the value associated with a key.
+     *
+     * @param key The key to search for.
+     * @return The value, or std::nullopt if the key is absent.
+     */
+    template<typename K>
+    std::optional<Value> find(const K &key) const {
+        Shard &s = shard_for(key);
+        std::shared_lock lock(s.mtx);
+        const shard_map &map = s.map;
+        auto it = map.find(key);
+        if (it == map.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    /**
+     * @brief Checks whether an element with the given key exists.
+     *
+     * @param key The key to search for.
+     * @return true if the key is present.
+     */
+    template<typename K>
+    bool contains(const K &key) const {
+        Shard &s = shard_for(key);
+        std::shared_lock lock(s.mtx);
+        return s.map.contains(key);
+    }
+
+    /**
+     * @brief Calls @p f on the element with the given key while holding its shard exclusively.
+     *
+     * @param key The key to search for.
+     * @param f   Callback invoked as f(value_type&).
+     * @return true if the key was found and @p f was called.
+     */
+    template<typename K, typename F>
+    bool visit(const K &key, F &&f) {
+        Shard &s = shard_for(key);
+        std::unique_lock lock(s.mtx);
+        auto it = s.map.find(key);
+        if (it == s.map.end())
+            return false;
+        f(*it);
+        return true;
+    }
+
+    /**
+     * @brief Calls @p f on the element with the given key while holding its shard in shared mode.
+     *
+     * @param key The key to search for.
+     * @param f   Callback invoked as f(const value_type&).
+     * @return true if the key was found and @p f was called.
+     */
+    template<typename K, typename F>
+    bool cvisit(const K &key, F &&f) const {
+        Shard &s = shard_for(key);
+        std::shared_lock lock(s.mtx);
+        const shard_map &map = s.map;
+        auto it = map.find(key);
+        if (it == map.end())
+            return false;
+        f(*it);
+        return true;
+    }
+
+    /**
+     * @brief Calls @p f on every element, one shard at a time, each under its shared lock.
+     *
+     * @param f Callback invoked as f(const value_type&).
+     */
+    template<typename F>
+    void for_each(F &&f) const {
+        for (size_t i = 0; i < shard_count; ++i) {
+            std::shared_lock lock(shards[i].mtx);
+            for (const auto &kv : shards[i].map)
+                f(kv);
+        }
+    }
+
+    /**
+     * @brief Calls @p f on every element, processing shards in parallel.
+     *
+     * Each shard is visited by a single task under its shared lock, so @p f may be invoked
+     * concurrently for elements of different shards and must be thread-safe.
+     *
+     * @param f Callback invoked as f(const value_type&).
+     */
+    template<typename F>
+    void parallel_for_each(F &&f) const {
+        std::vector<size_t> indices(shard_count);
+        std::iota(indices.begin(), indices.end(), size_t{0});
+        std::for_each(std::execution::par, indices.begin(), indices.end(), [this, &f](size_t i) {
+            std::shared_lock lock(shards[i].mtx);
+            for (const auto &kv : shards[i].map)
+                f(kv);
+        });
+    }
+};
+
+}
+#endif // CONCURRENT_HASH_MAP_HPP_
@@ -0,0 +1,461 @@
+#ifndef DENSE_HASH_MAP_HPP_
+#define DENSE_HASH_MAP_HPP_
+
+#include <algorithm>    // for std::max, std::fill
+#include <bit>          // for std::bit_ceil
+#include <concepts>     // for std::constructible_from
+#include <cstdint>      // for uint32_t
+#include <functional>   // for std::hash
+#include <initializer_list> // for std::initializer_list
+#include <iterator>     // for std::input_iterator, std::distance
+#include <span>         // for std::span
+#include <tuple>        // for std::forward_as_tuple
+#include <utility>      // for std::pair, std::move, std::swap, std::piecewise_construct
+#include <vector>       // for std::vector
+#include "hash.hpp"
+
+namespace mgc {
+
+/**
+ * @brief A hash map that keeps its elements in one dense, contiguous array.
+ *
+ * Elements live back to back in a std::vector in insertion order; a separate open-addressing
+ * index (linear probing, 8 bytes per bucket) maps each key to its position in that array.
+ * A full scan is therefore a linear walk over contiguous memory with no empty slots to
+ * skip, which the hardware prefetcher follows perfectly.
+ *
+ * Erasing moves the last element into the hole (swap-and-pop), so erase is O(1) but
+ * changes the order. With KeepOrder = true, erase instead shifts the following elements
+ * down and keeps insertion order, at O(n) per erase; use it for tables where erases are rare.
+ *
+ * Because elements are moved around, value_type has a non-const key: keys must never be
+ * modified through iterators or references. Inserts and erases invalidate iterators and
+ * references. A transparent Hash enables heterogeneous find/contains/erase. Holds at most
+ * 2^32 - 2 elements.
+ *
+ * @tparam Key       The key type. Must be move constructible and move assignable.
+ * @tparam Value     The mapped value type. Must be move constructible and move assignable.
+ * @tparam Hash      The hash function object type. Defaults to std::hash<Key>.
+ * @tparam KeepOrder Whether erase preserves insertion order. Defaults to false.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>, bool KeepOrder = false>
+class DenseHashMap {
+public:
+    /// The type of key-value pair stored in the map. The key must not be modified.
+    using value_type     = std::pair<Key, Value>;
+    /// Random-access iterator over the dense element array.
+    using iterator       = typename std::vector<value_type>::iterator;
+    /// Read-only random-access iterator over the dense element array.
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+private:
+    /**
+     * @brief One index bucket.
+     */
+    struct Bucket {
+        uint32_t hash; ///< Low 32 bits of the mixed hash; selects the home bucket and filters compares.
+        uint32_t idx;  ///< Position of the element in entries, or kEmpty.
+    };
+
+    static constexpr uint32_t kEmpty = ~uint32_t{0};   ///< idx of an unused bucket.
+    static constexpr size_t kMinCapacity = 16;         ///< Smallest bucket count.
+    static constexpr size_t kNotFound = ~size_t{0};    ///< Returned by find_bucket() for a missing key.
+
+    std::vector<value_type> entries; ///< The elements, densely packed.
+    std::vector<Bucket> buckets;     ///< Open-addressing index; the size is a power of two.
+    Hash hashFunc;                   ///< Hash function object.
+    double max_load;                 ///< Maximum ratio of elements to buckets before growing.
+
+    template<typename K>
+    uint32_t hash_of(const K &key) const { return static_cast<uint32_t>(detail::mix_hash(hashFunc(key))); }
+
+    size_t mask() const { return buckets.size() - 1; }
+
+    /**
+     * @brief Number of elements an index of @p cap buckets may hold; one bucket always stays empty.
+     */
+    size_t max_growth(size_t cap) const {
+        size_t limit = static_cast<size_t>(static_cast<double>(cap) * max_load);
+        return limit < cap ? limit : cap - 1;
+    }
+
+    /**
+     * @brief Returns the index of the bucket that refers to @p key, or kNotFound.
+     */
+    template<typename K>
+    size_t find_bucket(const K &key, uint32_t hash) const {
+        for (size_t i = hash & mask(); buckets[i].idx != kEmpty; i = (i + 1) & mask())
+            if (buckets[i].hash == hash && entries[buckets[i].idx].first == key)
+                return i;
+        return kNotFound;
+    }
+
+    /**
+     * @brief Points the first free bucket on the probe sequence of @p hash at element @p idx.
+     */
+    void place(uint32_t hash, uint32_t idx) {
+        size_t i = hash & mask();
+        while (buckets[i].idx != kEmpty)
+            i = (i + 1) & mask();
+        buckets[i] = {hash, idx};
+    }
+
+    /**
+     * @brief Rebuilds the index with @p new_cap buckets from the stored hash bits; no key is rehashed.
+     */
+    void rehash_internal(size_t new_cap) {
+        new_cap = std::bit_ceil(std::max(new_cap, kMinCapacity));
+        while (max_growth(new_cap) < entries.size())
+            new_cap *= 2;
+        std::vector<Bucket> old(new_cap, Bucket{0, kEmpty});
+        old.swap(buckets);
+        for (const Bucket &b : old)
+            if (b.idx != kEmpty)
+                place(b.hash, b.idx);
+    }
+
+    /**
+     * @brief Makes room for one more element.
+     */
+    void grow_if_needed() {
+        if (entries.size() + 1 > max_growth(buckets.size()))
+            rehash_internal(buckets.size() * 2);
+    }
+
+    /**
+     * @brief Returns the position of the element for a key, appending one built from @p args if the key is absent.
+     */
+    template<typename K, typename... Args>
+    std::pair<size_t, bool> try_emplace_index(K &&key, Args&&... args) {
+        uint32_t hash = hash_of(key);
+        if (size_t b = find_bucket(key, hash); b != kNotFound)
+            return {buckets[b].idx, false};
+        grow_if_needed();
+        entries.emplace_back(std::piecewise_construct,
+                             std::forward_as_tuple(std::forward<K>(key)),
+                             std::forward_as_tuple(std::forward<Args>(args)...));
+        place(hash, static_cast<uint32_t>(entries.size() - 1));
+        return {entries.size() - 1, true};
+    }
+
+    /**
+     * @brief Inserts a value for a key, or assigns it to the existing element.
+     */
+    template<typename K, typename M>
+    std::pair<size_t, bool> insert_or_assign_index(K &&key, M &&obj) {
+        uint32_t hash = hash_of(key);
+        if (size_t b = find_bucket(key, hash); b != kNotFound) {
+            entries[buckets[b].idx].second = std::forward<M>(obj);
+            return {buckets[b].idx, false};
+        }
+        grow_if_needed();
+        entries.emplace_back(std::forward<K>(key), std::forward<M>(obj));
+        place(hash, static_cast<uint32_t>(entries.size() - 1));
+        return {entries.size() - 1, true};
+    }
+
+    /**
+     * @brief Removes the element for a key, if any.
+     *
+     * The bucket is cleared with backward-shift deletion, so no tombstones are left behind.
+     * The element array is then closed either by moving the last element into the hole or,
+     * with KeepOrder, by shifting the tail down.
+     */
+    template<typename K>
+    void erase_key(const K &key) {
+        size_t b = find_bucket(key, hash_of(key));
+        if (b == kNotFound)
+            return;
+        const uint32_t idx = buckets[b].idx;
+
+        // Pull back following buckets that may legally occupy the hole.
+        size_t hole = b;
+        for (size_t k = (b + 1) & mask(); buckets[k].idx != kEmpty; k = (k + 1) & mask()) {
+            size_t home = buckets[k].hash & mask();
+            if (((k - home) & mask()) >= ((k - hole) & mask())) {
+                buckets[hole] = buckets[k];
+                hole = k;
+            }
+        }
+        buckets[hole].idx = kEmpty;
+
+        if constexpr (KeepOrder) {
+            entries.erase(entries.begin() + idx);
+            for (Bucket &bk : buckets)
+                if (bk.idx != kEmpty && bk.idx > idx)
+                    --bk.idx;
+        } else {
+            const uint32_t last = static_cast<uint32_t>(entries.size() - 1);
+            if (idx != last) {
+                size_t i = hash_of(entries[last].first) & mask();
+                while (buckets[i].idx != last)
+                    i = (i + 1) & mask();
+                buckets[i].idx = idx;
+                entries[idx] = std::move(entries[last]);
+            }
+            entries.pop_back();
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs an empty DenseHashMap.
+     *
+     * @param init_cap Initial number of index buckets, rounded up to a power of two (default is 16).
+     * @param load     Maximum load factor of the index before growing (default is 0.8).
+     * @param hash     Hash function object.
+     */
+    explicit DenseHashMap(size_t init_cap = 16, double load = 0.8, const Hash &hash = Hash())
+        : buckets(std::bit_ceil(std::max(init_cap, kMinCapacity)), Bucket{0, kEmpty}),
+          hashFunc(hash), max_load(load) {}
+
+    /**
+     * @brief Constructs a DenseHashMap from a range of key-value pairs, sized once for forward ranges.
+     *
+     * Duplicate keys behave like repeated insert(): the last value wins.
+     *
+     * @param first    Iterator to the first key-value pair.
+     * @param last     Iterator past the last key-value pair.
+     * @param init_cap Minimum initial number of index buckets (default is 16).
+     * @param load     Maximum load factor of the index before growing (default is 0.8).
+     * @param hash     Hash function object.
+     */
+    template<std::input_iterator InputIt>
+    DenseHashMap(InputIt first, InputIt last, size_t init_cap = 16, double load = 0.8, const Hash &hash = Hash())
+        : DenseHashMap(init_cap, load, hash)
+    {
+        if constexpr (std::forward_iterator<InputIt>)
+            reserve(static_cast<size_t>(std::distance(first, last)));
+        for (; first != last; ++first) {
+            const auto &kv = *first;
+            insert_or_assign_index(kv.first, kv.second);
+        }
+    }
+
+    /**
+     * @brief Constructs a DenseHashMap from an initializer list.
+     *
+     * @param init The key-value pairs to insert.
+     */
+    DenseHashMap(std::initializer_list<std::pair<const Key, Value>> init)
+        : DenseHashMap(init.begin(), init.end()) {}
+
+    /**
+     * @brief Returns the number of elements.
+     */
+    size_t size() const { return entries.size(); }
+
+    /**
+     * @brief Checks whether the map is empty.
+     */
+    bool empty() const { return entries.empty(); }
+
+    /**
+     * @brief Returns the number of index buckets.
+     */
+    size_t bucket_count() const { return buckets.size(); }
+
+    /**
+     * @brief Returns the number of positions for for_each_in(), i.e. the number of elements.
+     */
+    size_t scan_extent() const { return entries.size(); }
+
+    /**
+     * @brief Calls @p f on the elements at positions [first, last) of the dense array.
+     *
+     * @param first First position, at most scan_extent().
+     * @param last  Position past the last one, at most scan_extent().
+     * @param f     Callback invoked as f(const value_type&).
+     */
+    template<typename F>
+    void for_each_in(size_t first, size_t last, F &&f) const {
+        for (size_t i = first; i < last; ++i)
+            f(entries[i]);
+    }
+
+    /**
+     * @brief Returns the load factor of the index.
+     */
+    double load_factor() const {
+        return static_cast<double>(entries.size()) / static_cast<double>(buckets.size());
+    }
+
+    /**
+     * @brief Removes every element. The index and the element array keep their capacity.
+     */
+    void clear() {
+        entries.clear();
+        std::fill(buckets.begin(), buckets.end(), Bucket{0, kEmpty});
+    }
+
+    /**
+     * @brief Swaps the contents of this DenseHashMap with another.
+     */
+    void swap(DenseHashMap &other) noexcept {
+        entries.swap(other.entries);
+        buckets.swap(other.buckets);
+        std::swap(hashFunc, other.hashFunc);
+        std::swap(max_load, other.max_load);
+    }
+
+    /**
+     * @brief Rebuilds the index with at least @p new_cap buckets (never fewer than the elements need).
+     */
+    void rehash(size_t new_cap) { rehash_internal(new_cap); }
+
+    /**
+     * @brief Makes room for at least @p n elements without further rehashing or reallocation.
+     */
+    void reserve(size_t n) {
+        entries.reserve(n);
+        size_t cap = buckets.size();
+        while (max_growth(cap) < n)
+            cap *= 2;
+        if (cap != buckets.size())
+            rehash_internal(cap);
+    }
+
+    /**
+     * @brief Shrinks the element array and the index to what the current elements need.
+     */
+    void shrink_to_fit() {
+        entries.shrink_to_fit();
+        rehash_internal(0);
+    }
+
+    /**
+     * @brief Inserts a key-value pair, or assigns the value if the key already exists.
+     */
+    void insert(const Key &key, const Value &value) { insert_or_assign_index(key, value); }
+
+    /**
+     * @brief Inserts a key-value pair, moving from the arguments.
+     */
+    void insert(Key &&key, Value &&value) { insert_or_assign_index(std::move(key), std::move(value)); }
+
+    /**
+     * @brief Inserts an element with the value constructed from @p args, unless the key already exists.
+     *
+     * @param key  The key to insert.
+     * @param args Arguments forwarded to the Value constructor.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args&&... args) {
+        auto [idx, inserted] = try_emplace_index(key, std::forward<Args>(args)...);
+        return {entries.begin() + static_cast<std::ptrdiff_t>(idx), inserted};
+    }
+
+    /**
+     * @brief Inserts an element with the value constructed from @p args, moving from the key.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(Key &&key, Args&&... args) {
+        auto [idx, inserted] = try_emplace_index(std::move(key), std::forward<Args>(args)...);
+        return {entries.begin() + static_cast<std::ptrdiff_t>(idx), inserted};
+    }
+
+    /**
+     * @brief Heterogeneous try_emplace: the key is only converted to Key if the insertion takes place.
+     */
+    template<typename K, typename... Args>
+        requires transparent_hash<Hash> && std::constructible_from<Key, K>
+    std::pair<iterator, bool> try_emplace(K &&key, Args&&... args) {
+        auto [idx, inserted] = try_emplace_index(std::forward<K>(key), std::forward<Args>(args)...);
+        return {entries.begin() + static_cast<std::ptrdiff_t>(idx), inserted};
+    }
+
+    /**
+     * @brief Inserts a new element or assigns to the mapped value of an existing one.
+     *
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+        auto [idx, inserted] = insert_or_assign_index(key, std::forward<M>(obj));
+        return {entries.begin() + static_cast<std::ptrdiff_t>(idx), inserted};
+    }
+
+    /**
+     * @brief Access operator; inserts a default-constructed value if the key is absent.
+     */
+    Value& operator[](const Key &key) { return entries[try_emplace_index(key).first].second; }
+
+    /**
+     * @brief Access operator that moves from the key if a new element is inserted.
+     */
+    Value& operator[](Key &&key) { return entries[try_emplace_index(std::move(key)).first].second; }
+
+    /**
+     * @brief Erases the element with the given key.
+     */
+    void erase(const Key &key) { erase_key(key); }
+
+    /**
+     * @brief Erases the element with an equivalent key (heterogeneous version).
+     */
+    template<typename K> requires transparent_hash<Hash>
+    void erase(const K &key) { erase_key(key); }
+
+    /**
+     * @brief Finds an element by key.
+     *
+     * @return An iterator to the element if found, or end() if not found.
+     */
+    iterator find(const Key &key) {
+        size_t b = find_bucket(key, hash_of(key));
+        return b == kNotFound ? entries.end() : entries.begin() + buckets[b].idx;
+    }
+
+    /**
+     * @brief Finds an element by key (const version).
+     */
+    const_iterator find(const Key &key) const {
+        size_t b = find_bucket(key, hash_of(key));
+        return b == kNotFound ? entries.end() : entries.begin() + buckets[b].idx;
+    }
+
+    /**
+     * @brief Finds an element with an equivalent key (heterogeneous version).
+     */
+    template<typename K> requires transparent_hash<Hash>
+    iterator find(const K &key) {
+        size_t b = find_bucket(key, hash_of(key));
+        return b == kNotFound ? entries.end() : entries.begin() + buckets[b].idx;
+    }
+
+    /**
+     * @brief Finds an element with an equivalent key (heterogeneous const version).
+     */
+    template<typename K> requires transparent_hash<Hash>
+    const_iterator find(const K &key) const {
+        size_t b = find_bucket(key, hash_of(key));
+        return b == kNotFound ? entries.end() : entries.begin() + buckets[b].idx;
+    }
+
+    /**
+     * @brief Checks whether an element with the given key exists.
+     */
+    bool contains(const Key &key) const { return find_bucket(key, hash_of(key)) != kNotFound; }
+
+    /**
+     * @brief Checks whether an element with an equivalent key exists (heterogeneous version).
+     */
+    template<typename K> requires transparent_hash<Hash>
+    bool contains(const K &key) const { return find_bucket(key, hash_of(key)) != kNotFound; }
+
+    /**
+     * @brief Returns the elements as one contiguous array, e.g. for SIMD or parallel scans.
+     */
+    std::span<const value_type> values() const { return entries; }
+
+    iterator begin() { return entries.begin(); }
+    iterator end()   { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const   { return entries.end(); }
+    const_iterator cbegin() const { return entries.cbegin(); }
+    const_iterator cend() const   { return entries.cend(); }
+};
+
+}
+#endif // DENSE_HASH_MAP_HPP_
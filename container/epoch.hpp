@@ -0,0 +1,153 @@
+#ifndef EPOCH_HPP_
+#define EPOCH_HPP_
+
+#include <atomic>       // for std::atomic
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint64_t
+#include <stdexcept>    // for std::runtime_error
+
+namespace mgc {
+
+/**
+ * @brief Epoch-based memory reclamation for lock-free readers.
+ *
+ * Readers pin the current global epoch for the duration of a traversal. A writer that
+ * unlinks an object tags it with the global epoch at that moment and may free it once
+ * the global epoch has advanced twice past the tag: by then every reader that could
+ * have seen the object has unpinned. The epoch only advances when every pinned reader
+ * has observed the current value, so a stalled reader delays reclamation but never
+ * blocks anyone.
+ *
+ * There is a single process-wide domain (instance()). Each thread claims one of
+ * kMaxThreads records on its first pin and releases it when the thread exits.
+ */
+class EpochDomain {
+public:
+    static constexpr size_t kMaxThreads = 256; ///< Maximum number of threads pinned at the same time.
+
+    /**
+     * @brief RAII pin of the current epoch. Guards may be nested on the same thread.
+     */
+    class Guard {
+    public:
+        explicit Guard(EpochDomain &d) : domain(d) { domain.pin(); }
+        ~Guard() { domain.unpin(); }
+        Guard(const Guard &) = delete;
+        Guard& operator=(const Guard &) = delete;
+    private:
+        EpochDomain &domain; ///< The domain pinned by this guard.
+    };
+
+    /**
+     * @brief Returns the process-wide domain.
+     */
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    /**
+     * @brief Returns the current global epoch. Objects retired now are tagged with it.
+     */
+    uint64_t current() const { return global_epoch.load(std::memory_order_seq_cst); }
+
+    /**
+     * @brief Advances the global epoch if every pinned thread has observed the current one.
+     *
+     * @return true if the epoch was advanced.
+     */
+    bool try_advance() {
+        uint64_t e = global_epoch.load(std::memory_order_seq_cst);
+        size_t n = used.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t st = records[i].state.load(std::memory_order_seq_cst);
+            if ((st & 1) && (st >> 1) != e)
+                return false;
+        }
+        return global_epoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Checks whether an object retired in epoch @p retired can no longer be reached by any reader.
+     */
+    bool safe_to_reclaim(uint64_t retired) const { return current() >= retired + 2; }
+
+private:
+    /**
+     * @brief Per-thread pin state, padded to its own cache line.
+     */
+    struct alignas(64) Record {
+        std::atomic<uint64_t> state{0};  ///< 0 when not pinned, otherwise (epoch << 1) | 1.
+        std::atomic<bool> in_use{false}; ///< Whether a live thread owns this record.
+    };
+
+    /**
+     * @brief Thread-local handle to the record owned by the calling thread.
+     */
+    struct ThreadHandle {
+        Record* rec = nullptr; ///< Claimed record, or nullptr before the first pin.
+        unsigned depth = 0;    ///< Nesting depth of guards on this thread.
+
+        ~ThreadHandle() {
+            if (rec) {
+                rec->state.store(0, std::memory_order_release);
+                rec->in_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    std::atomic<uint64_t> global_epoch{0}; ///< The global epoch.
+    std::atomic<size_t> used{0};           ///< Records [0, used) have been claimed at least once.
+    Record records[kMaxThreads];           ///< Per-thread records.
+
+    EpochDomain() = default;
+
+    static ThreadHandle& handle() {
+        thread_local ThreadHandle h;
+        return h;
+    }
+
+    /**
+     * @brief Claims a free record for the calling thread.
+     *
+     * @throws std::runtime_error if more than kMaxThreads threads are registered at once.
+     */
+    Record* acquire_record() {
+        for (size_t i = 0; i < kMaxThreads; ++i) {
+            bool expected = false;
+            if (records[i].in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                size_t n = used.load(std::memory_order_relaxed);
+                while (n < i + 1 && !used.compare_exchange_weak(n, i + 1, std::memory_order_acq_rel)) {}
+                return &records[i];
+            }
+        }
+        throw std::runtime_error("EpochDomain: too many threads");
+    }
+
+    void pin() {
+        ThreadHandle &h = handle();
+        if (!h.rec)
+            h.rec = acquire_record();
+        if (h.depth++ == 0) {
+            // Retry until the published pin matches the global epoch, so an advance racing
+            // with the pin cannot leave this thread announcing a stale epoch.
+            uint64_t e = global_epoch.load(std::memory_order_seq_cst);
+            for (;;) {
+                h.rec->state.store((e << 1) | 1, std::memory_order_seq_cst);
+                uint64_t now = global_epoch.load(std::memory_order_seq_cst);
+                if (now == e)
+                    break;
+                e = now;
+            }
+        }
+    }
+
+    void unpin() {
+        ThreadHandle &h = handle();
+        if (--h.depth == 0)
+            h.rec->state.store(0, std::memory_order_release);
+    }
+};
+
+}
+#endif // EPOCH_HPP_
@@ -0,0 +1,156 @@
+#ifndef FIXED_KEY_HPP_
+#define FIXED_KEY_HPP_
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint32_t
+#include <cstring>      // for std::memcpy, std::memcmp, std::memset
+#include <functional>   // for std::hash
+#include <stdexcept>    // for std::length_error
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include "hash.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace mgc {
+
+/**
+ * @brief A short string key stored inline in a fixed number of bytes.
+ *
+ * The characters are zero-padded to N - 1 bytes and the last byte holds the length, so
+ * two keys are equal exactly when all N bytes are equal. Equality is therefore one or two
+ * vector compares, with no length check and no loop over characters. The key never
+ * allocates, and it carries its hash, computed once at construction with
+ * seeded_string_hash.
+ *
+ * Use fixed_key_hash (or std::hash) as the hasher. Both are transparent over
+ * std::string_view, so lookups with a view never build a key.
+ *
+ * @tparam N Total size of the character buffer in bytes, a multiple of 16 up to 256. Holds up to N - 1 characters.
+ */
+template<size_t N>
+class alignas(16) fixed_key {
+    static_assert(N % 16 == 0 && N >= 16 && N <= 256, "fixed_key size must be a multiple of 16 up to 256");
+
+    char bytes[N];     ///< Characters, zero padding, and the length in the last byte.
+    size_t hash_value; ///< seeded_string_hash of the characters.
+
+public:
+    /// Maximum number of characters.
+    static constexpr size_t max_size = N - 1;
+
+    /**
+     * @brief Constructs an empty key.
+     */
+    fixed_key() noexcept : fixed_key(std::string_view()) {}
+
+    /**
+     * @brief Constructs a key holding a copy of @p s.
+     *
+     * @param s The characters of the key.
+     * @throws std::length_error if @p s is longer than max_size.
+     */
+    explicit fixed_key(std::string_view s) {
+        if (s.size() > max_size)
+            throw std::length_error("Error: Key is too long");
+        std::memset(bytes, 0, N);
+        if (!s.empty())
+            std::memcpy(bytes, s.data(), s.size());
+        bytes[N - 1] = static_cast<char>(s.size());
+        hash_value = seeded_string_hash()(view());
+    }
+
+    /**
+     * @brief Returns the number of characters.
+     */
+    size_t size() const noexcept { return static_cast<unsigned char>(bytes[N - 1]); }
+
+    /**
+     * @brief Returns the characters as a view into the key.
+     */
+    std::string_view view() const noexcept { return std::string_view(bytes, size()); }
+
+    /**
+     * @brief Returns the characters as a std::string.
+     */
+    std::string str() const { return std::string(view()); }
+
+    /**
+     * @brief Returns the hash computed at construction.
+     */
+    size_t hash() const noexcept { return hash_value; }
+
+    /**
+     * @brief Compares two keys with full-width vector compares.
+     */
+    friend bool operator==(const fixed_key &a, const fixed_key &b) noexcept {
+        if (a.hash_value != b.hash_value)
+            return false;
+#if defined(__AVX2__)
+        if constexpr (N % 32 == 0) {
+            for (size_t i = 0; i < N; i += 32) {
+                // The key is only 16-byte aligned, so the 32-byte loads must be unaligned ones.
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.bytes + i));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.bytes + i));
+                if (static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y))) != 0xFFFFFFFFu)
+                    return false;
+            }
+            return true;
+        }
+#endif
+#if defined(__SSE2__)
+        for (size_t i = 0; i < N; i += 16) {
+            __m128i x = _mm_load_si128(reinterpret_cast<const __m128i*>(a.bytes + i));
+            __m128i y = _mm_load_si128(reinterpret_cast<const __m128i*>(b.bytes + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xFFFF)
+                return false;
+        }
+        return true;
+#else
+        return std::memcmp(a.bytes, b.bytes, N) == 0;
+#endif
+    }
+
+    /**
+     * @brief Compares a key with a string view (heterogeneous lookup).
+     */
+    friend bool operator==(const fixed_key &a, std::string_view s) noexcept {
+        return a.size() == s.size() && (s.empty() || std::memcmp(a.bytes, s.data(), s.size()) == 0);
+    }
+};
+
+/**
+ * @brief Transparent hash for fixed_key that returns the precomputed hash.
+ *
+ * A std::string_view is hashed exactly like the key built from it, so maps keyed by
+ * fixed_key can be searched with views.
+ */
+struct fixed_key_hash {
+    using is_transparent = void; ///< Enables heterogeneous lookup.
+
+    template<size_t N>
+    size_t operator()(const fixed_key<N> &k) const noexcept { return k.hash(); }
+    size_t operator()(std::string_view s) const noexcept { return seeded_string_hash()(s); }
+    size_t operator()(const std::string &s) const noexcept { return (*this)(std::string_view(s)); }
+    size_t operator()(const char *s) const noexcept { return (*this)(std::string_view(s)); }
+};
+
+/**
+ * @brief fixed_key already carries its hash, so node-based maps do not cache a second copy.
+ */
+template<size_t N, typename Hash>
+struct cache_hash<fixed_key<N>, Hash> : std::false_type {};
+
+}
+
+/**
+ * @brief std::hash for fixed_key returns the precomputed hash.
+ */
+template<size_t N>
+struct std::hash<mgc::fixed_key<N>> : mgc::fixed_key_hash {};
+
+#endif // FIXED_KEY_HPP_
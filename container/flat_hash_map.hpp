@@ -0,0 +1,1217 @@
+#ifndef FLAT_HASH_MAP_HPP_
+#define FLAT_HASH_MAP_HPP_
+
+#include <algorithm>    // for std::min
+#include <bit>          // for std::countr_zero, std::bit_ceil
+#include <concepts>     // for std::constructible_from
+#include <cstdint>      // for int8_t, uint32_t
+#include <cstring>      // for std::memset, std::memcpy
+#include <functional>   // for std::hash
+#include <initializer_list> // for std::initializer_list
+#include <iterator>     // for std::bidirectional_iterator_tag, std::input_iterator, std::distance
+#include <memory>       // for std::allocator, std::construct_at, std::destroy_at
+#include <ranges>       // for std::ranges::random_access_range, std::ranges::size
+#include <stdexcept>    // for std::out_of_range, std::invalid_argument
+#include <tuple>        // for std::forward_as_tuple
+#include <type_traits>  // for std::is_nothrow_move_constructible_v, std::is_copy_constructible_v
+#include <utility>      // for std::pair, std::move, std::swap, std::piecewise_construct, std::as_const
+#include "hash.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace mgc {
+
+namespace detail {
+
+/// Control byte type. Full slots hold the 7-bit H2 hash fragment (0..127), special states are negative.
+using ctrl_t = int8_t;
+
+inline constexpr ctrl_t kEmpty   = -128; ///< Slot has never been used since the last rehash/clear.
+inline constexpr ctrl_t kDeleted = -2;   ///< Tombstone left by erase() so probe sequences stay intact.
+
+/**
+ * @brief A group of control bytes scanned in parallel.
+ *
+ * With AVX2 a group covers 32 slots, with SSE2 it covers 16 slots; otherwise a
+ * portable scalar loop produces the same bitmasks. Bit i of every mask refers to slot i of the group.
+ */
+struct Group {
+#if defined(__AVX2__)
+    static constexpr size_t kWidth = 32;
+
+    explicit Group(const ctrl_t* pos)
+        : ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos))) {}
+
+    /// Slots whose H2 fragment equals @p h2.
+    uint32_t match(ctrl_t h2) const {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl)));
+    }
+    /// Slots that are empty.
+    uint32_t match_empty() const { return match(kEmpty); }
+    /// Slots that are empty or deleted (sign bit set).
+    uint32_t match_empty_or_deleted() const {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(ctrl));
+    }
+    /// Slots that hold an element.
+    uint32_t match_full() const { return ~match_empty_or_deleted(); }
+
+    __m256i ctrl;
+#elif defined(__SSE2__)
+    static constexpr size_t kWidth = 16;
+
+    explicit Group(const ctrl_t* pos)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+    uint32_t match(ctrl_t h2) const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+    }
+    uint32_t match_empty() const { return match(kEmpty); }
+    uint32_t match_empty_or_deleted() const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+    }
+    uint32_t match_full() const { return ~match_empty_or_deleted() & 0xFFFFu; }
+
+    __m128i ctrl;
+#else
+    static constexpr size_t kWidth = 16;
+
+    explicit Group(const ctrl_t* pos) : ctrl(pos) {}
+
+    uint32_t match(ctrl_t h2) const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < kWidth; ++i)
+            if (ctrl[i] == h2)
+                mask |= 1u << i;
+        return mask;
+    }
+    uint32_t match_empty() const { return match(kEmpty); }
+    uint32_t match_empty_or_deleted() const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < kWidth; ++i)
+            if (ctrl[i] < 0)
+                mask |= 1u << i;
+        return mask;
+    }
+    uint32_t match_full() const { return ~match_empty_or_deleted() & 0xFFFFu; }
+
+    const ctrl_t* ctrl;
+#endif
+};
+
+} // namespace detail
+
+/**
+ * @brief A hash map implementation using open addressing over flat storage.
+ *
+ * This template class offers the same interface as mgc::HashMap, but keeps its elements
+ * in one contiguous slot array instead of one heap node per element. A parallel array of
+ * control bytes stores a 7-bit fragment of each element's hash; lookups scan a whole group
+ * of control bytes with one SIMD compare and touch the slot array only on fragment matches.
+ * A successful lookup therefore usually costs one cache line of metadata and one of slots.
+ *
+ * Unlike mgc::HashMap, iteration order is unspecified, and insert/erase/rehash may
+ * move elements, invalidating iterators and references. As with mgc::HashMap, a
+ * transparent Hash enables heterogeneous find/contains/erase.
+ *
+ * @tparam Key      The key type. Must be default constructible.
+ * @tparam Value    The mapped value type. Must be default constructible.
+ * @tparam Hash     The hash function object type. Defaults to std::hash<Key>.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatHashMap {
+public:
+    /// The type of key-value pair stored in the map.
+    using value_type = std::pair<const Key, Value>;
+
+private:
+    using ctrl_t = detail::ctrl_t;
+    using Group  = detail::Group;
+
+    static constexpr size_t kMinCapacity = Group::kWidth; ///< Smallest non-zero slot count.
+    static constexpr size_t kPrefetchBatch = 16;          ///< Keys hashed and prefetched together by visit_many().
+
+    /**
+     * @brief Storage for one element.
+     *
+     * Elements are constructed as value_type, whose key is const to users of the map.
+     * mutable_value is the same pair with a non-const key, so that a rehash can move the
+     * key out of a slot that is destroyed right after without casting away const.
+     */
+    union slot_type {
+        value_type value;                    ///< The element as seen through iterators.
+        std::pair<Key, Value> mutable_value; ///< The element as moved by rehash_internal().
+        slot_type() {}
+        ~slot_type() {}
+    };
+
+    /// Rehashing moves elements only if that cannot throw; otherwise it copies them, leaving the old table intact.
+    static constexpr bool kMoveOnRehash =
+        (std::is_nothrow_move_constructible_v<Key> && std::is_nothrow_move_constructible_v<Value>) ||
+        !std::is_copy_constructible_v<value_type>;
+
+    ctrl_t* ctrl;        ///< Control bytes, one per slot.
+    slot_type* slots;    ///< Slot array; only slots with a full control byte are constructed.
+    size_t capacity;     ///< Number of slots (zero or a power of two, at least one group).
+    size_t count;        ///< Number of elements stored.
+    size_t growth_left;  ///< Empty slots that may still be filled before a rehash is required.
+    Hash hashFunc;       ///< Hash function object.
+    double max_load;     ///< Maximum load factor threshold before rehashing.
+
+    static size_t H1(size_t hash) { return hash >> 7; }
+    static ctrl_t H2(size_t hash) { return static_cast<ctrl_t>(hash & 0x7F); }
+
+    /// The table indexes with the low bits of the hash, so weak hashes (std::hash for integers is the identity) are mixed first.
+    template<typename K>
+    size_t hash_of(const K &key) const { return detail::mix_hash(hashFunc(key)); }
+
+    /**
+     * @brief Number of elements a table of @p cap slots may hold.
+     *
+     * At least one slot is always left empty so that every probe sequence terminates.
+     */
+    size_t max_growth(size_t cap) const {
+        if (!cap)
+            return 0;
+        size_t limit = static_cast<size_t>(static_cast<double>(cap) * max_load);
+        return limit < cap ? limit : cap - 1;
+    }
+
+    /**
+     * @brief Rounds a requested slot count up to a valid capacity that can hold @p elements elements.
+     */
+    size_t normalize_capacity(size_t new_cap, size_t elements) const {
+        size_t cap = std::bit_ceil(new_cap < kMinCapacity ? kMinCapacity : new_cap);
+        while (max_growth(cap) < elements)
+            cap *= 2;
+        return cap;
+    }
+
+    /**
+     * @brief Rounds a requested slot count up to a valid capacity that can hold all current elements.
+     */
+    size_t normalize_capacity(size_t new_cap) const { return normalize_capacity(new_cap, count); }
+
+    /**
+     * @brief Locates the slot holding @p key.
+     *
+     * @tparam K   Key or a type comparable with Key (heterogeneous lookup).
+     * @param key  The key to search for.
+     * @param hash The mixed hash of @p key.
+     * @return The slot index, or capacity if the key is absent.
+     */
+    template<typename K>
+    size_t find_index(const K &key, size_t hash) const {
+        if (!capacity)
+            return capacity;
+        const size_t groups_mask = capacity / Group::kWidth - 1;
+        const ctrl_t h2 = H2(hash);
+        size_t g = H1(hash) & groups_mask;
+        // Triangular probing over groups visits every group once for power-of-two group counts.
+        for (size_t step = 1; ; ++step) {
+            const size_t base = g * Group::kWidth;
+            Group group(ctrl + base);
+            for (uint32_t m = group.match(h2); m; m &= m - 1) {
+                size_t idx = base + static_cast<size_t>(std::countr_zero(m));
+                if (slots[idx].value.first == key)
+                    return idx;
+            }
+            if (group.match_empty())
+                return capacity;
+            g = (g + step) & groups_mask;
+        }
+    }
+
+    /**
+     * @brief Resolves a batch of keys in three passes so that their cache misses overlap.
+     *
+     * Blocks of kPrefetchBatch keys are hashed and the control bytes of their first probe
+     * groups prefetched, then the first candidate slot of every group is prefetched, and only
+     * then are the probe sequences walked.
+     *
+     * @param self The map (const or not), which selects the iterator type passed to @p f.
+     * @param keys Random-access range of keys.
+     * @param f    Callback invoked as f(index, iterator) for every key, in order.
+     */
+    template<typename Self, typename R, typename F>
+    static void visit_many_impl(Self &self, R &keys, F &f) {
+        using It = decltype(self.end());
+        const size_t n = std::ranges::size(keys);
+        auto first = std::ranges::begin(keys);
+        const size_t groups_mask = self.capacity ? self.capacity / Group::kWidth - 1 : 0;
+        size_t hashes[kPrefetchBatch];
+        for (size_t base = 0; base < n; base += kPrefetchBatch) {
+            const size_t m = std::min(kPrefetchBatch, n - base);
+            for (size_t j = 0; j < m; ++j) {
+                hashes[j] = self.hash_of(first[base + j]);
+                if (self.capacity)
+                    __builtin_prefetch(self.ctrl + (H1(hashes[j]) & groups_mask) * Group::kWidth);
+            }
+            if (self.capacity) {
+                for (size_t j = 0; j < m; ++j) {
+                    const size_t g = (H1(hashes[j]) & groups_mask) * Group::kWidth;
+                    if (uint32_t match = Group(self.ctrl + g).match(H2(hashes[j])))
+                        __builtin_prefetch(self.slots + g + static_cast<size_t>(std::countr_zero(match)));
+                }
+            }
+            for (size_t j = 0; j < m; ++j)
+                f(base + j, It(self.find_index(first[base + j], hashes[j]), &self));
+        }
+    }
+
+    /**
+     * @brief Finds the first empty or deleted slot on the probe sequence of @p hash.
+     */
+    size_t find_insert_slot(size_t hash) const { return find_insert_slot(ctrl, capacity, hash); }
+
+    /**
+     * @brief Finds the first empty or deleted slot on the probe sequence of @p hash in the
+     *        control bytes @p c of a table with @p cap slots.
+     */
+    static size_t find_insert_slot(const ctrl_t *c, size_t cap, size_t hash) {
+        const size_t groups_mask = cap / Group::kWidth - 1;
+        size_t g = H1(hash) & groups_mask;
+        for (size_t step = 1; ; ++step) {
+            Group group(c + g * Group::kWidth);
+            if (uint32_t m = group.match_empty_or_deleted())
+                return g * Group::kWidth + static_cast<size_t>(std::countr_zero(m));
+            g = (g + step) & groups_mask;
+        }
+    }
+
+    /**
+     * @brief Finds @p key or reserves a slot for it.
+     *
+     * A reserved slot is not yet marked full; the caller constructs the element and then calls commit_insert().
+     *
+     * @tparam K   Key or a type comparable with Key (heterogeneous lookup).
+     * @param key  The key to search for.
+     * @param hash The mixed hash of @p key.
+     * @return The slot index and true if the slot was reserved for a new element.
+     */
+    template<typename K>
+    std::pair<size_t, bool> find_or_prepare_insert(const K &key, size_t hash) {
+        size_t idx = find_index(key, hash);
+        if (idx != capacity)
+            return {idx, false};
+        // The new table must have room for the element about to be inserted, not just the current ones.
+        if (!capacity) {
+            rehash_internal(normalize_capacity(kMinCapacity, count + 1));
+        } else if (growth_left == 0 && ctrl[find_insert_slot(hash)] != detail::kDeleted) {
+            // Reclaim tombstones at the same size if they dominate, otherwise grow.
+            rehash_internal(normalize_capacity(count * 2 < max_growth(capacity) ? capacity : capacity * 2, count + 1));
+        }
+        return {find_insert_slot(hash), true};
+    }
+
+    /**
+     * @brief Marks a freshly constructed slot as full.
+     */
+    void commit_insert(size_t idx, size_t hash) {
+        if (ctrl[idx] == detail::kEmpty)
+            --growth_left;
+        ctrl[idx] = H2(hash);
+        ++count;
+    }
+
+    /**
+     * @brief Returns the slot for a key, constructing the element in place from @p args if the key is absent.
+     *
+     * The key is hashed and probed once; it is only converted to Key when an element is created.
+     *
+     * @return The slot index and true if the element was newly inserted.
+     */
+    template<typename K, typename... Args>
+    std::pair<size_t, bool> try_emplace_index(K &&key, Args&&... args) {
+        size_t hash = hash_of(key);
+        auto [idx, inserted] = find_or_prepare_insert(key, hash);
+        if (inserted) {
+            std::construct_at(&slots[idx].value, std::piecewise_construct,
+                              std::forward_as_tuple(std::forward<K>(key)),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
+            commit_insert(idx, hash);
+        }
+        return {idx, inserted};
+    }
+
+    /**
+     * @brief Inserts a value for a key, or assigns it to the existing element.
+     *
+     * @return The slot index and true if the element was newly inserted.
+     */
+    template<typename K, typename M>
+    std::pair<size_t, bool> insert_or_assign_index(K &&key, M &&obj) {
+        size_t hash = hash_of(key);
+        auto [idx, inserted] = find_or_prepare_insert(key, hash);
+        if (!inserted) {
+            slots[idx].value.second = std::forward<M>(obj);
+            return {idx, false};
+        }
+        std::construct_at(&slots[idx].value, std::forward<K>(key), std::forward<M>(obj));
+        commit_insert(idx, hash);
+        return {idx, true};
+    }
+
+    /**
+     * @brief Destroys the element in slot @p idx and releases the slot.
+     *
+     * If the slot's group still contains an empty slot, no probe sequence can pass through the group,
+     * so the slot may become empty again; otherwise a tombstone is left behind.
+     */
+    void erase_index(size_t idx) {
+        std::destroy_at(&slots[idx].value);
+        const size_t base = idx - idx % Group::kWidth;
+        if (Group(ctrl + base).match_empty()) {
+            ctrl[idx] = detail::kEmpty;
+            ++growth_left;
+        } else {
+            ctrl[idx] = detail::kDeleted;
+        }
+        --count;
+    }
+
+    /**
+     * @brief Allocates control bytes and slots for @p cap slots and marks them empty.
+     */
+    static void allocate(size_t cap, ctrl_t *&out_ctrl, slot_type *&out_slots) {
+        out_ctrl = new ctrl_t[cap];
+        std::memset(out_ctrl, detail::kEmpty, cap);
+        try {
+            out_slots = std::allocator<slot_type>().allocate(cap);
+        } catch (...) {
+            delete[] out_ctrl;
+            throw;
+        }
+    }
+
+    /**
+     * @brief Releases arrays obtained from allocate(). Elements must already be destroyed.
+     */
+    static void deallocate(size_t cap, ctrl_t *c, slot_type *s) {
+        delete[] c;
+        if (s)
+            std::allocator<slot_type>().deallocate(s, cap);
+    }
+
+    /**
+     * @brief Internal rehash function.
+     *
+     * Places every element into a freshly allocated table, dropping all tombstones. The new
+     * table is filled while the old one stays intact and replaces it only once complete:
+     * elements are moved if neither Key nor Value can throw while moving (see kMoveOnRehash),
+     * and copied otherwise, so a throwing copy leaves the map unchanged. Hash must not throw
+     * for keys that are already stored.
+     *
+     * @param new_cap The requested number of slots.
+     */
+    void rehash_internal(size_t new_cap) {
+        new_cap = normalize_capacity(new_cap);
+        ctrl_t* new_ctrl;
+        slot_type* new_slots;
+        allocate(new_cap, new_ctrl, new_slots);
+        try {
+            for (size_t i = 0; i < capacity; ++i) {
+                if (ctrl[i] < 0)
+                    continue;
+                size_t hash = hash_of(slots[i].value.first);
+                size_t idx = find_insert_slot(new_ctrl, new_cap, hash);
+                if constexpr (kMoveOnRehash)
+                    std::construct_at(&new_slots[idx].value, std::move(slots[i].mutable_value));
+                else
+                    std::construct_at(&new_slots[idx].value, std::as_const(slots[i].value));
+                new_ctrl[idx] = H2(hash);
+            }
+        } catch (...) {
+            for (size_t i = 0; i < new_cap; ++i)
+                if (new_ctrl[i] >= 0)
+                    std::destroy_at(&new_slots[i].value);
+            deallocate(new_cap, new_ctrl, new_slots);
+            throw;
+        }
+        for (size_t i = 0; i < capacity; ++i)
+            if (ctrl[i] >= 0)
+                std::destroy_at(&slots[i].value);
+        deallocate(capacity, ctrl, slots);
+        ctrl = new_ctrl;
+        slots = new_slots;
+        capacity = new_cap;
+        growth_left = max_growth(capacity) - count;
+    }
+
+    /// Index of the first full slot at or after @p idx, or capacity.
+    size_t next_full(size_t idx) const {
+        while (idx < capacity && ctrl[idx] < 0)
+            ++idx;
+        return idx;
+    }
+
+    /// Index of the last full slot before @p idx, or capacity if there is none.
+    size_t prev_full(size_t idx) const {
+        while (idx > 0) {
+            --idx;
+            if (ctrl[idx] >= 0)
+                return idx;
+        }
+        return capacity;
+    }
+
+public:
+    /**
+     * @brief Const bidirectional iterator for FlatHashMap.
+     *
+     * Allows read-only traversal of the map's elements in slot order.
+     */
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = std::pair<const Key, Value>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const value_type*;
+        using reference         = const value_type&;
+
+        /**
+         * @brief Default constructor.
+         */
+        const_iterator() : idx(0), map(nullptr) {}
+
+        /**
+         * @brief Constructs an iterator from a slot index and associated map.
+         *
+         * @param i Index of a full slot, or the map's capacity for end().
+         * @param m Pointer to the associated FlatHashMap.
+         */
+        const_iterator(size_t i, const FlatHashMap* m) : idx(i), map(m) {}
+
+        /**
+         * @brief Dereference operator.
+         *
+         * @return Reference to the key-value pair.
+         */
+        reference operator*() const { return map->slots[idx].value; }
+
+        /**
+         * @brief Arrow operator.
+         *
+         * @return Pointer to the key-value pair.
+         */
+        pointer operator->() const { return &map->slots[idx].value; }
+
+        /**
+         * @brief Pre-increment operator.
+         *
+         * @return Reference to the iterator after increment.
+         */
+        const_iterator& operator++() {
+            idx = map->next_full(idx + 1);
+            return *this;
+        }
+
+        /**
+         * @brief Post-increment operator.
+         *
+         * @return Iterator before increment.
+         */
+        const_iterator operator++(int) {
+            const_iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        /**
+         * @brief Pre-decrement operator.
+         *
+         * If the iterator is at end(), it moves to the last element.
+         *
+         * @return Reference to the iterator after decrement.
+         * @throws std::out_of_range if decrement is not possible.
+         */
+        const_iterator& operator--() {
+            size_t prev = map ? map->prev_full(idx) : 0;
+            if (!map || prev == map->capacity)
+                throw std::out_of_range("Cannot decrement iterator");
+            idx = prev;
+            return *this;
+        }
+
+        /**
+         * @brief Post-decrement operator.
+         *
+         * @return Iterator before decrement.
+         */
+        const_iterator operator--(int) {
+            const_iterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+        /**
+         * @brief Equality comparison.
+         *
+         * @param other Another iterator.
+         * @return true if both iterators point to the same slot.
+         */
+        bool operator==(const const_iterator &other) const { return idx == other.idx; }
+
+        /**
+         * @brief Inequality comparison.
+         *
+         * @param other Another iterator.
+         * @return true if iterators do not point to the same slot.
+         */
+        bool operator!=(const const_iterator &other) const { return idx != other.idx; }
+    private:
+        size_t idx;              ///< Index of the current slot.
+        const FlatHashMap* map;  ///< Pointer to the associated FlatHashMap.
+        friend class FlatHashMap;
+    };
+
+    /**
+     * @brief Mutable bidirectional iterator for FlatHashMap.
+     *
+     * Allows modifying the mapped value.
+     */
+    class iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = std::pair<const Key, Value>;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = value_type*;
+        using reference         = value_type&;
+
+        /**
+         * @brief Default constructor.
+         */
+        iterator() : idx(0), map(nullptr) {}
+
+        /**
+         * @brief Constructs an iterator from a slot index and associated map.
+         *
+         * @param i Index of a full slot, or the map's capacity for end().
+         * @param m Pointer to the associated FlatHashMap.
+         */
+        iterator(size_t i, const FlatHashMap* m) : idx(i), map(m) {}
+
+        /**
+         * @brief Dereference operator.
+         *
+         * @return Reference to the key-value pair.
+         */
+        reference operator*() const { return map->slots[idx].value; }
+
+        /**
+         * @brief Arrow operator.
+         *
+         * @return Pointer to the key-value pair.
+         */
+        pointer operator->() const { return &map->slots[idx].value; }
+
+        /**
+         * @brief Pre-increment operator.
+         *
+         * @return Reference to the iterator after increment.
+         */
+        iterator& operator++() {
+            idx = map->next_full(idx + 1);
+            return *this;
+        }
+
+        /**
+         * @brief Post-increment operator.
+         *
+         * @return Iterator before increment.
+         */
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        /**
+         * @brief Pre-decrement operator.
+         *
+         * If the iterator is at end(), it moves to the last element.
+         *
+         * @return Reference to the iterator after decrement.
+         * @throws std::out_of_range if decrement is not possible.
+         */
+        iterator& operator--() {
+            size_t prev = map ? map->prev_full(idx) : 0;
+            if (!map || prev == map->capacity)
+                throw std::out_of_range("Cannot decrement iterator");
+            idx = prev;
+            return *this;
+        }
+
+        /**
+         * @brief Post-decrement operator.
+         *
+         * @return Iterator before decrement.
+         */
+        iterator operator--(int) {
+            iterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+        /**
+         * @brief Equality comparison.
+         *
+         * @param other Another iterator.
+         * @return true if both iterators point to the same slot.
+         */
+        bool operator==(const iterator &other) const { return idx == other.idx; }
+
+        /**
+         * @brief Inequality comparison.
+         *
+         * @param other Another iterator.
+         * @return true if iterators do not point to the same slot.
+         */
+        bool operator!=(const iterator &other) const { return idx != other.idx; }
+    private:
+        size_t idx;              ///< Index of the current slot.
+        const FlatHashMap* map;  ///< Pointer to the associated FlatHashMap.
+        friend class FlatHashMap;
+    };
+
+    /**
+     * @brief Constructs an empty FlatHashMap with an initial slot capacity and load factor threshold.
+     *
+     * @param init_cap Initial number of slots, rounded up to a power of two (default is 16).
+     * @param load     Maximum load factor before rehashing, in (0, 1] (default is 0.875).
+     * @throws std::invalid_argument if @p load is not in (0, 1].
+     */
+    explicit FlatHashMap(size_t init_cap = 16, double load = 0.875)
+        : ctrl(nullptr), slots(nullptr), capacity(0), count(0), growth_left(0), max_load(load)
+    {
+        if (!(load > 0 && load <= 1))
+            throw std::invalid_argument("Error: Load factor must be in (0, 1]");
+        if (init_cap) {
+            capacity = normalize_capacity(init_cap);
+            allocate(capacity, ctrl, slots);
+            growth_left = max_growth(capacity);
+        }
+    }
+
+    /**
+     * @brief Constructs a FlatHashMap from a range of key-value pairs.
+     *
+     * For forward ranges the table is sized for the whole range up front, so the elements
+     * are placed in a single pass without any intermediate rehash. Duplicate keys behave
+     * like repeated insert(): the last value wins.
+     *
+     * @param first    Iterator to the first key-value pair.
+     * @param last     Iterator past the last key-value pair.
+     * @param init_cap Minimum initial number of slots (default is 16).
+     * @param load     Maximum load factor before rehashing (default is 0.875).
+     */
+    template<std::input_iterator InputIt>
+    FlatHashMap(InputIt first, InputIt last, size_t init_cap = 16, double load = 0.875)
+        : FlatHashMap(init_cap, load)
+    {
+        if constexpr (std::forward_iterator<InputIt>)
+            reserve(static_cast<size_t>(std::distance(first, last)));
+        for (; first != last; ++first) {
+            const auto &kv = *first;
+            insert_or_assign_index(kv.first, kv.second);
+        }
+    }
+
+    /**
+     * @brief Constructs a FlatHashMap from an initializer list, sized once for all of its elements.
+     *
+     * @param init     The key-value pairs to insert.
+     * @param init_cap Minimum initial number of slots (default is 16).
+     * @param load     Maximum load factor before rehashing (default is 0.875).
+     */
+    FlatHashMap(std::initializer_list<value_type> init, size_t init_cap = 16, double load = 0.875)
+        : FlatHashMap(init.begin(), init.end(), init_cap, load) {}
+
+    /**
+     * @brief Copy constructor.
+     *
+     * Creates a deep copy of the given FlatHashMap. The slot layout is copied as is, so no key is rehashed.
+     * If an element copy throws, the elements copied so far and the arrays are freed.
+     *
+     * @param other The FlatHashMap to copy.
+     */
+    FlatHashMap(const FlatHashMap &other)
+        : ctrl(nullptr), slots(nullptr), capacity(0), count(0), growth_left(0),
+          hashFunc(other.hashFunc), max_load(other.max_load)
+    {
+        if (!other.capacity)
+            return;
+        allocate(other.capacity, ctrl, slots);
+        capacity = other.capacity;
+        try {
+            for (size_t i = 0; i < capacity; ++i) {
+                if (other.ctrl[i] >= 0) {
+                    std::construct_at(&slots[i].value, other.slots[i].value);
+                    ++count;
+                }
+                ctrl[i] = other.ctrl[i];
+            }
+        } catch (...) {
+            // The destructor does not run for a throwing constructor; free what was built.
+            for (size_t i = 0; i < capacity; ++i)
+                if (ctrl[i] >= 0)
+                    std::destroy_at(&slots[i].value);
+            deallocate(capacity, ctrl, slots);
+            throw;
+        }
+        growth_left = other.growth_left;
+    }
+
+    /**
+     * @brief Move constructor.
+     *
+     * Transfers ownership of resources from the given FlatHashMap.
+     *
+     * @param other The FlatHashMap to move.
+     */
+    FlatHashMap(FlatHashMap &&other) noexcept
+        : ctrl(other.ctrl), slots(other.slots), capacity(other.capacity), count(other.count),
+          growth_left(other.growth_left), hashFunc(std::move(other.hashFunc)), max_load(other.max_load)
+    {
+        other.ctrl = nullptr;
+        other.slots = nullptr;
+        other.capacity = 0;
+        other.count = 0;
+        other.growth_left = 0;
+    }
+
+    /**
+     * @brief Destructor.
+     *
+     * Clears all elements and frees allocated resources.
+     */
+    ~FlatHashMap() {
+        clear();
+        deallocate(capacity, ctrl, slots);
+    }
+
+    /**
+     * @brief Copy assignment operator.
+     *
+     * @param other The FlatHashMap to copy.
+     * @return Reference to this FlatHashMap.
+     */
+    FlatHashMap& operator=(const FlatHashMap &other) {
+        if (this != &other) {
+            FlatHashMap temp(other);
+            swap(temp);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment operator.
+     *
+     * @param other The FlatHashMap to move.
+     * @return Reference to this FlatHashMap.
+     */
+    FlatHashMap& operator=(FlatHashMap &&other) noexcept {
+        if (this != &other) {
+            FlatHashMap temp(std::move(other));
+            swap(temp);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Swaps the contents of this FlatHashMap with another.
+     *
+     * @param other The FlatHashMap to swap with.
+     */
+    void swap(FlatHashMap &other) noexcept {
+        std::swap(ctrl, other.ctrl);
+        std::swap(slots, other.slots);
+        std::swap(capacity, other.capacity);
+        std::swap(count, other.count);
+        std::swap(growth_left, other.growth_left);
+        std::swap(hashFunc, other.hashFunc);
+        std::swap(max_load, other.max_load);
+    }
+
+    /**
+     * @brief Clears the FlatHashMap.
+     *
+     * Destroys all elements and marks every slot empty; the slot array is kept.
+     */
+    void clear() {
+        if (!capacity)
+            return;
+        for (size_t i = 0; i < capacity; ++i)
+            if (ctrl[i] >= 0)
+                std::destroy_at(&slots[i].value);
+        std::memset(ctrl, detail::kEmpty, capacity);
+        count = 0;
+        growth_left = max_growth(capacity);
+    }
+
+    /**
+     * @brief Returns the number of elements in the FlatHashMap.
+     *
+     * @return The number of stored key-value pairs.
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Returns the current load factor.
+     *
+     * @return The ratio of the number of elements to the number of slots.
+     */
+    double load_factor() const {
+        return capacity ? static_cast<double>(count) / static_cast<double>(capacity) : 0;
+    }
+
+    /**
+     * @brief Manually rehashes the FlatHashMap.
+     *
+     * The slot count is rounded up to a power of two large enough for the current elements.
+     *
+     * @param new_cap The requested number of slots.
+     */
+    void rehash(size_t new_cap) { rehash_internal(new_cap); }
+
+    /**
+     * @brief Returns the number of slots.
+     */
+    size_t bucket_count() const { return capacity; }
+
+    /**
+     * @brief Returns the number of positions for for_each_in(), i.e. the number of slots.
+     */
+    size_t scan_extent() const { return capacity; }
+
+    /**
+     * @brief Calls @p f on every element stored in slots [first, last).
+     *
+     * Disjoint slot ranges hold disjoint elements, so a full scan can be split into
+     * independent ranges and processed concurrently (see mgc::parallel_for_each).
+     *
+     * @param first First slot, at most scan_extent().
+     * @param last  Slot past the last one, at most scan_extent().
+     * @param f     Callback invoked as f(const value_type&).
+     */
+    template<typename F>
+    void for_each_in(size_t first, size_t last, F &&f) const {
+        for (size_t i = first; i < last; ++i)
+            if (ctrl[i] >= 0)
+                f(slots[i].value);
+    }
+
+    /**
+     * @brief Makes room for at least @p n elements without further rehashing.
+     *
+     * Rehashes once if the free slots (tombstones do not count) cannot take the missing
+     * elements; otherwise does nothing.
+     *
+     * @param n The number of elements to make room for.
+     */
+    void reserve(size_t n) {
+        if (n > count + growth_left)
+            rehash_internal(normalize_capacity(capacity, n));
+    }
+
+    /**
+     * @brief Releases memory no longer needed by the current elements.
+     *
+     * Moves the elements into the smallest table that holds them under max_load, if that is
+     * smaller than the current one. Iterators are invalidated.
+     */
+    void shrink_to_fit() {
+        size_t cap = normalize_capacity(0);
+        if (cap < capacity)
+            rehash_internal(cap);
+    }
+
+    /**
+     * @brief Inserts a key-value pair into the FlatHashMap.
+     *
+     * If the key already exists, its value is updated.
+     *
+     * @param key   The key to insert.
+     * @param value The value associated with the key.
+     */
+    void insert(const Key &key, const Value &value) { insert_or_assign_index(key, value); }
+
+    /**
+     * @brief Inserts a key-value pair into the FlatHashMap, moving from the arguments.
+     *
+     * If the key already exists, its value is move-assigned.
+     *
+     * @param key   The key to insert.
+     * @param value The value associated with the key.
+     */
+    void insert(Key &&key, Value &&value) { insert_or_assign_index(std::move(key), std::move(value)); }
+
+    /**
+     * @brief Inserts an element constructed from @p args, unless its key already exists.
+     *
+     * The pair is built in a temporary first so that its key can be hashed; on insertion
+     * the key and value are moved into the slot.
+     *
+     * @param args Arguments forwarded to the key-value pair constructor.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        std::pair<Key, Value> tmp(std::forward<Args>(args)...);
+        auto [idx, inserted] = try_emplace_index(std::move(tmp.first), std::move(tmp.second));
+        return {iterator(idx, this), inserted};
+    }
+
+    /**
+     * @brief Inserts an element with the value constructed from @p args, unless the key already exists.
+     *
+     * Nothing is constructed, copied or moved if the key is present.
+     *
+     * @param key  The key to insert.
+     * @param args Arguments forwarded to the Value constructor.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args&&... args) {
+        auto [idx, inserted] = try_emplace_index(key, std::forward<Args>(args)...);
+        return {iterator(idx, this), inserted};
+    }
+
+    /**
+     * @brief Inserts an element with the value constructed from @p args, moving from the key.
+     *
+     * @param key  The key to insert; it is only moved from if the insertion takes place.
+     * @param args Arguments forwarded to the Value constructor.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(Key &&key, Args&&... args) {
+        auto [idx, inserted] = try_emplace_index(std::move(key), std::forward<Args>(args)...);
+        return {iterator(idx, this), inserted};
+    }
+
+    /**
+     * @brief Heterogeneous try_emplace: the key is only converted to Key if the insertion takes place.
+     *
+     * @param key  A value comparable with Key and convertible to it, e.g. a std::string_view for string keys.
+     * @param args Arguments forwarded to the Value constructor.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename K, typename... Args>
+        requires transparent_hash<Hash> && std::constructible_from<Key, K>
+    std::pair<iterator, bool> try_emplace(K &&key, Args&&... args) {
+        auto [idx, inserted] = try_emplace_index(std::forward<K>(key), std::forward<Args>(args)...);
+        return {iterator(idx, this), inserted};
+    }
+
+    /**
+     * @brief Inserts a new element or assigns to the mapped value of an existing one.
+     *
+     * @param key The key to insert or update.
+     * @param obj The value to store.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+        auto [idx, inserted] = insert_or_assign_index(key, std::forward<M>(obj));
+        return {iterator(idx, this), inserted};
+    }
+
+    /**
+     * @brief Inserts a new element or assigns to the mapped value of an existing one, moving from the key.
+     *
+     * @param key The key to insert or update.
+     * @param obj The value to store.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(Key &&key, M &&obj) {
+        auto [idx, inserted] = insert_or_assign_index(std::move(key), std::forward<M>(obj));
+        return {iterator(idx, this), inserted};
+    }
+
+    /**
+     * @brief Access operator.
+     *
+     * Returns a reference to the mapped value associated with the given key.
+     * If the key is not found, a new element with a default-constructed value is inserted.
+     *
+     * @param key The key to access.
+     * @return Reference to the associated value.
+     */
+    Value& operator[](const Key &key) {
+        // The insertion may rehash, so the slot array is read only afterwards.
+        size_t idx = try_emplace_index(key).first;
+        return slots[idx].value.second;
+    }
+
+    /**
+     * @brief Access operator that moves from the key if a new element is inserted.
+     *
+     * @param key The key to access.
+     * @return Reference to the associated value.
+     */
+    Value& operator[](Key &&key) {
+        size_t idx = try_emplace_index(std::move(key)).first;
+        return slots[idx].value.second;
+    }
+
+    /**
+     * @brief Erases the element with the given key.
+     *
+     * @param key The key of the element to erase.
+     */
+    void erase(const Key &key) {
+        size_t idx = find_index(key, hash_of(key));
+        if (idx != capacity)
+            erase_index(idx);
+    }
+
+    /**
+     * @brief Erases the element with an equivalent key (heterogeneous version).
+     *
+     * @param key A value comparable with Key, e.g. a std::string_view for string keys.
+     */
+    template<typename K> requires transparent_hash<Hash>
+    void erase(const K &key) {
+        size_t idx = find_index(key, hash_of(key));
+        if (idx != capacity)
+            erase_index(idx);
+    }
+
+    /**
+     * @brief Finds an element by key.
+     *
+     * @param key The key to search for.
+     * @return An iterator to the element if found, or end() if not found.
+     */
+    iterator find(const Key &key) { return iterator(find_index(key, hash_of(key)), this); }
+
+    /**
+     * @brief Finds an element by key (const version).
+     *
+     * @param key The key to search for.
+     * @return A const_iterator to the element if found, or end() if not found.
+     */
+    const_iterator find(const Key &key) const { return const_iterator(find_index(key, hash_of(key)), this); }
+
+    /**
+     * @brief Finds an element with an equivalent key (heterogeneous version).
+     *
+     * @param key A value comparable with Key, e.g. a std::string_view for string keys.
+     * @return An iterator to the element if found, or end() if not found.
+     */
+    template<typename K> requires transparent_hash<Hash>
+    iterator find(const K &key) { return iterator(find_index(key, hash_of(key)), this); }
+
+    /**
+     * @brief Finds an element with an equivalent key (heterogeneous const version).
+     *
+     * @param key A value comparable with Key, e.g. a std::string_view for string keys.
+     * @return A const_iterator to the element if found, or end() if not found.
+     */
+    template<typename K> requires transparent_hash<Hash>
+    const_iterator find(const K &key) const { return const_iterator(find_index(key, hash_of(key)), this); }
+
+    /**
+     * @brief Checks whether an element with the given key exists.
+     *
+     * @param key The key to search for.
+     * @return true if the key is present.
+     */
+    bool contains(const Key &key) const { return find_index(key, hash_of(key)) != capacity; }
+
+    /**
+     * @brief Checks whether an element with an equivalent key exists (heterogeneous version).
+     *
+     * @param key A value comparable with Key, e.g. a std::string_view for string keys.
+     * @return true if the key is present.
+     */
+    template<typename K> requires transparent_hash<Hash>
+    bool contains(const K &key) const { return find_index(key, hash_of(key)) != capacity; }
+
+    /**
+     * @brief Looks up a batch of keys, overlapping their memory latency.
+     *
+     * Equivalent to calling find() for every key in order, but the keys are hashed and
+     * their first probe groups prefetched in blocks before any of them is resolved.
+     * @p f must not insert into or erase from the map.
+     *
+     * @param keys Random-access range of keys (Key, or compatible types if Hash is transparent).
+     * @param f    Callback invoked as f(index, iterator), where iterator is end() for a missing key.
+     */
+    template<std::ranges::random_access_range R, typename F>
+        requires std::ranges::sized_range<R>
+              && (transparent_hash<Hash> || std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<R>>, Key>)
+    void visit_many(R &&keys, F &&f) { visit_many_impl(*this, keys, f); }
+
+    /**
+     * @brief Looks up a batch of keys, overlapping their memory latency (const version).
+     *
+     * @param keys Random-access range of keys (Key, or compatible types if Hash is transparent).
+     * @param f    Callback invoked as f(index, const_iterator), where the iterator is end() for a missing key.
+     */
+    template<std::ranges::random_access_range R, typename F>
+        requires std::ranges::sized_range<R>
+              && (transparent_hash<Hash> || std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<R>>, Key>)
+    void visit_many(R &&keys, F &&f) const { visit_many_impl(*this, keys, f); }
+
+    /**
+     * @brief Looks up a batch of keys and writes one iterator per key to @p out.
+     *
+     * @param keys Random-access range of keys (Key, or compatible types if Hash is transparent).
+     * @param out  Output iterator receiving an iterator per key, end() for a missing key.
+     */
+    template<std::ranges::random_access_range R, typename OutIt>
+    void find_many(R &&keys, OutIt out) {
+        visit_many(keys, [&out](size_t, iterator it) { *out++ = it; });
+    }
+
+    /**
+     * @brief Returns an iterator to the first element.
+     *
+     * @return Iterator pointing to the first element.
+     */
+    iterator begin() { return iterator(next_full(0), this); }
+
+    /**
+     * @brief Returns an iterator past the last element.
+     *
+     * @return Iterator representing end().
+     */
+    iterator end()   { return iterator(capacity, this); }
+
+    /**
+     * @brief Returns a const iterator to the first element.
+     *
+     * @return Const iterator pointing to the first element.
+     */
+    const_iterator begin() const { return const_iterator(next_full(0), this); }
+
+    /**
+     * @brief Returns a const iterator past the last element.
+     *
+     * @return Const iterator representing end().
+     */
+    const_iterator end() const   { return const_iterator(capacity, this); }
+
+    /**
+     * @brief Returns a const iterator to the first element.
+     *
+     * @return Const iterator pointing to the first element.
+     */
+    const_iterator cbegin() const { return const_iterator(next_full(0), this); }
+
+    /**
+     * @brief Returns a const iterator past the last element.
+     *
+     * @return Const iterator representing end().
+     */
+    const_iterator cend() const   { return const_iterator(capacity, this); }
+};
+
+}
+#endif // FLAT_HASH_MAP_HPP_
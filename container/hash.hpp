@@ -0,0 +1,157 @@
+#ifndef MGC_HASH_HPP_
+#define MGC_HASH_HPP_
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint64_t
+#include <cstring>      // for std::memcpy
+#include <functional>   // for std::hash
+#include <random>       // for std::random_device
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include <type_traits>  // for std::bool_constant, std::is_arithmetic_v
+
+namespace mgc {
+
+/**
+ * @brief Satisfied by hash function objects that declare heterogeneous lookup support.
+ *
+ * Like the standard containers, mgc maps enable their templated find/contains/erase
+ * overloads only when the hasher has a nested `is_transparent` type.
+ */
+template<typename H>
+concept transparent_hash = requires { typename H::is_transparent; };
+
+/**
+ * @brief Whether node-based mgc maps store the full hash of each key next to it.
+ *
+ * A cached hash lets a rehash relink nodes without calling the hasher again and lets
+ * chain walks reject most non-matching nodes without comparing keys, at the cost of one
+ * word per node. Enabled by default except for arithmetic, enum and pointer keys, whose
+ * hashes and comparisons are already trivial. Specialize it to override the choice.
+ *
+ * @tparam Key  The key type.
+ * @tparam Hash The hash function object type.
+ */
+template<typename Key, typename Hash>
+struct cache_hash
+    : std::bool_constant<!std::is_arithmetic_v<Key> && !std::is_enum_v<Key> && !std::is_pointer_v<Key>> {};
+
+namespace detail {
+
+/**
+ * @brief Post-mixes a hash value.
+ *
+ * Spreads every input bit over the whole word with a multiply-xorshift step, so tables
+ * that index with a subset of the bits also work with weak hashes such as the identity
+ * std::hash for integers.
+ */
+inline size_t mix_hash(size_t h) {
+    uint64_t x = h;
+    x ^= x >> 32;
+    x *= 0x9E3779B97F4A7C15ull;
+    x ^= x >> 29;
+    return static_cast<size_t>(x);
+}
+
+/**
+ * @brief Folded 64x64->128 bit multiplication, the core step of the seeded byte hash.
+ */
+inline uint64_t mul_fold(uint64_t a, uint64_t b) {
+    unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+/**
+ * @brief Returns a per-process random seed, drawn once on first use.
+ */
+inline size_t process_seed() {
+    static const size_t seed = [] {
+        std::random_device rd;
+        return (static_cast<size_t>(rd()) << 32) ^ rd();
+    }();
+    return seed;
+}
+
+} // namespace detail
+
+/**
+ * @brief Transparent hash for string keys.
+ *
+ * Hashes std::string, std::string_view and C strings identically, so a map keyed by
+ * std::string can be searched with a view into a parse buffer without building a temporary string.
+ */
+struct string_hash {
+    using is_transparent = void; ///< Enables heterogeneous lookup.
+
+    size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+    size_t operator()(const std::string &s) const noexcept { return (*this)(std::string_view(s)); }
+    size_t operator()(const char *s) const noexcept { return (*this)(std::string_view(s)); }
+};
+
+/**
+ * @brief Seeded, transparent hash for string keys.
+ *
+ * Hashes the bytes of the string together with a secret seed, so the bucket of a key
+ * cannot be predicted without knowing the seed. Use it for maps whose keys come from
+ * outside (e.g. ciphers in incoming orders) to resist hash-flooding. By default the
+ * seed is drawn at random once per process.
+ */
+struct seeded_string_hash {
+    using is_transparent = void; ///< Enables heterogeneous lookup.
+
+    size_t seed; ///< Secret seed mixed into every hash.
+
+    /**
+     * @brief Constructs a hasher with the per-process random seed.
+     */
+    seeded_string_hash() noexcept : seed(detail::process_seed()) {}
+
+    /**
+     * @brief Constructs a hasher with an explicit seed (e.g. for reproducible tests).
+     *
+     * @param s The seed.
+     */
+    explicit seeded_string_hash(size_t s) noexcept : seed(s) {}
+
+    size_t operator()(std::string_view s) const noexcept {
+        constexpr uint64_t k0 = 0xA0761D6478BD642Full, k1 = 0xE7037ED1A0B428DBull;
+        const char* p = s.data();
+        size_t n = s.size();
+        uint64_t h = seed ^ (n * k0);
+        for (; n >= 8; n -= 8, p += 8) {
+            uint64_t w;
+            std::memcpy(&w, p, 8);
+            h = detail::mul_fold(h ^ w, seed ^ k1);
+        }
+        uint64_t tail = 0;
+        if (n)
+            std::memcpy(&tail, p, n);
+        h = detail::mul_fold(h ^ tail, seed ^ k0);
+        return static_cast<size_t>(detail::mul_fold(h, k1));
+    }
+    size_t operator()(const std::string &s) const noexcept { return (*this)(std::string_view(s)); }
+    size_t operator()(const char *s) const noexcept { return (*this)(std::string_view(s)); }
+};
+
+/**
+ * @brief Wraps any hash function object and mixes a secret seed into its result.
+ *
+ * Suitable for keys whose base hash has no full collisions (e.g. integers). For strings
+ * prefer seeded_string_hash, which seeds the byte hash itself.
+ *
+ * @tparam Hash The underlying hash function object type.
+ */
+template<typename Hash>
+struct seeded_hash {
+    Hash base;   ///< Underlying hash function object.
+    size_t seed; ///< Secret seed mixed into every hash.
+
+    seeded_hash() : base(), seed(detail::process_seed()) {}
+    explicit seeded_hash(size_t s, const Hash &h = Hash()) : base(h), seed(s) {}
+
+    template<typename K>
+    size_t operator()(const K &key) const { return detail::mix_hash(base(key) ^ seed); }
+};
+
+}
+#endif // MGC_HASH_HPP_
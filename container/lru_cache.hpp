@@ -0,0 +1,203 @@
+#ifndef LRU_CACHE_HPP_
+#define LRU_CACHE_HPP_
+
+#include <functional>   // for std::function, std::hash
+#include <limits>       // for std::numeric_limits
+#include <utility>      // for std::forward, std::move
+#include "unordered_map.hpp"
+
+namespace mgc {
+
+/**
+ * @brief A bounded least-recently-used cache on top of mgc::HashMap.
+ *
+ * HashMap already threads every node on a doubly linked list. The cache keeps that list
+ * in recency order by moving an element to the back whenever it is inserted or read
+ * (HashMap::touch), and evicts from the front. Every operation is O(1), and no second
+ * index is needed.
+ *
+ * The cache is bounded by a number of entries, a byte budget, or both. The byte size of an
+ * entry comes from a weigher callback, evaluated once when the entry is stored and kept with
+ * it, so later changes to a value through get() do not change its charge. An optional
+ * eviction callback sees every entry just before it is evicted; it may move the value out.
+ *
+ * @tparam Key      The key type.
+ * @tparam Value    The cached value type.
+ * @tparam Hash     The hash function object type. Defaults to std::hash<Key>.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    /// Returns the byte size charged for an entry.
+    using weigher_type = std::function<size_t(const Key&, const Value&)>;
+    /// Called with an entry just before it is evicted.
+    using evict_callback = std::function<void(const Key&, Value&)>;
+
+    /// Bound meaning "no limit".
+    static constexpr size_t kUnbounded = std::numeric_limits<size_t>::max();
+
+private:
+    /**
+     * @brief A cached value and the weight charged for it when it was stored.
+     */
+    struct entry {
+        Value value;   ///< The cached value.
+        size_t weight; ///< Weight added to bytes for this entry.
+
+        template<typename V>
+        explicit entry(V &&v) : value(std::forward<V>(v)), weight(0) {}
+    };
+
+    HashMap<Key, entry, Hash> map;  ///< Entries, iterated from least to most recently used.
+    size_t max_entries;             ///< Maximum number of entries.
+    size_t max_bytes;               ///< Maximum total weight of the entries.
+    size_t bytes;                   ///< Current total weight of the entries.
+    weigher_type weigher;           ///< Byte size of an entry, or empty to charge nothing.
+    evict_callback on_evict;        ///< Eviction callback, or empty.
+
+    size_t weigh(const Key &key, const Value &value) const { return weigher ? weigher(key, value) : 0; }
+
+    /**
+     * @brief Evicts least recently used entries until both bounds hold.
+     */
+    void enforce_bounds() {
+        while (map.size() > 0 && (map.size() > max_entries || bytes > max_bytes)) {
+            auto lru = map.begin();
+            bytes -= lru->second.weight;
+            if (on_evict)
+                on_evict(lru->first, lru->second.value);
+            map.erase(lru);
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs an empty cache.
+     *
+     * @param entries  Maximum number of entries (default is unbounded).
+     * @param budget   Maximum total weight in bytes (default is unbounded).
+     * @param w        Weigher returning the byte size of an entry; needed for a byte budget.
+     * @param evict    Callback invoked on every evicted entry.
+     */
+    explicit LruCache(size_t entries = kUnbounded, size_t budget = kUnbounded,
+                      weigher_type w = nullptr, evict_callback evict = nullptr)
+        : max_entries(entries), max_bytes(budget), bytes(0),
+          weigher(std::move(w)), on_evict(std::move(evict)) {}
+
+    /**
+     * @brief Returns the number of cached entries.
+     */
+    size_t size() const { return map.size(); }
+
+    /**
+     * @brief Returns the total weight of the cached entries.
+     */
+    size_t weight() const { return bytes; }
+
+    /**
+     * @brief Changes the bounds, evicting entries if they no longer fit.
+     *
+     * @param entries Maximum number of entries.
+     * @param budget  Maximum total weight in bytes.
+     */
+    void set_limits(size_t entries, size_t budget = kUnbounded) {
+        max_entries = entries;
+        max_bytes = budget;
+        enforce_bounds();
+    }
+
+    /**
+     * @brief Stores a value and marks it most recently used, then evicts as needed.
+     *
+     * An entry heavier than the whole budget is evicted right away.
+     *
+     * @param key   The key.
+     * @param value The value; replaces any cached value for the key.
+     */
+    template<typename K, typename V>
+    void put(K &&key, V &&value) {
+        auto it = map.find(key);
+        if (it != map.end()) {
+            bytes -= it->second.weight;
+            it->second.weight = 0;
+            it->second.value = std::forward<V>(value);
+        } else {
+            it = map.try_emplace(std::forward<K>(key), std::forward<V>(value)).first;
+        }
+        it->second.weight = weigh(it->first, it->second.value);
+        bytes += it->second.weight;
+        map.touch(it);
+        enforce_bounds();
+    }
+
+    /**
+     * @brief Looks up a value and marks it most recently used.
+     *
+     * The value may be modified; its weight stays the one charged when it was stored.
+     *
+     * @param key The key (Key, or a compatible type if Hash is transparent).
+     * @return Pointer to the cached value, valid until the next put/erase, or nullptr on a miss.
+     */
+    template<typename K>
+    Value* get(const K &key) {
+        auto it = map.find(key);
+        if (it == map.end())
+            return nullptr;
+        map.touch(it);
+        return &it->second.value;
+    }
+
+    /**
+     * @brief Looks up a value without changing its recency.
+     *
+     * @param key The key (Key, or a compatible type if Hash is transparent).
+     * @return Pointer to the cached value, or nullptr on a miss.
+     */
+    template<typename K>
+    const Value* peek(const K &key) const {
+        auto it = map.find(key);
+        return it == map.end() ? nullptr : &it->second.value;
+    }
+
+    /**
+     * @brief Checks whether a key is cached, without changing its recency.
+     */
+    template<typename K>
+    bool contains(const K &key) const { return map.contains(key); }
+
+    /**
+     * @brief Removes an entry without calling the eviction callback.
+     *
+     * @param key The key (Key, or a compatible type if Hash is transparent).
+     */
+    template<typename K>
+    void erase(const K &key) {
+        auto it = map.find(key);
+        if (it == map.end())
+            return;
+        bytes -= it->second.weight;
+        map.erase(it);
+    }
+
+    /**
+     * @brief Removes every entry without calling the eviction callback.
+     */
+    void clear() {
+        map.clear();
+        bytes = 0;
+    }
+
+    /**
+     * @brief Calls @p f on every entry, from least to most recently used.
+     *
+     * @param f Callback invoked as f(const Key&, const Value&).
+     */
+    template<typename F>
+    void for_each(F &&f) const {
+        for (const auto &kv : map)
+            f(kv.first, kv.second.value);
+    }
+};
+
+}
+#endif // LRU_CACHE_HPP_
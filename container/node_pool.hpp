@@ -0,0 +1,272 @@
+#ifndef NODE_POOL_HPP_
+#define NODE_POOL_HPP_
+
+#include <cstddef>      // for size_t
+#include <algorithm>    // for std::find
+#include <memory>       // for std::allocator, std::allocator_traits, std::shared_ptr, std::allocate_shared
+#include <utility>      // for std::swap
+#include <vector>       // for std::vector
+
+namespace mgc {
+
+/**
+ * @brief A fixed-size object pool that carves objects out of large slabs.
+ *
+ * Storage for objects of type T is handed out from slabs obtained through the
+ * allocator; freed objects go onto an intrusive free list and are reused by the
+ * next allocation. Slabs are only returned to the allocator all at once by release()
+ * or the destructor, so churn-heavy containers stop hitting the global heap.
+ *
+ * Objects may migrate between pools (e.g. when a map hands a node to another map). The
+ * slabs of a pool belong to a reference-counted arena: a pool that takes over foreign
+ * objects adopts the arenas they came from (adopt()), and a lease() keeps them alive
+ * while objects are in transit. An arena is freed once no pool or lease refers to it.
+ *
+ * The pool manages raw storage only: callers construct and destroy objects themselves.
+ *
+ * @tparam T         The object type stored in the pool.
+ * @tparam Allocator The allocator used for slabs. Rebound internally, so any allocator type works.
+ */
+template<typename T, typename Allocator = std::allocator<T>>
+class NodePool {
+    /**
+     * @brief One pool slot.
+     *
+     * A slot holds either an object, a free-list link, or (as the first slot of a slab) the slab header.
+     */
+    union Slot {
+        Slot* next_free;                               ///< Next slot on the free list.
+        struct {
+            Slot* next_slab;                           ///< Next slab in the slab list.
+            size_t size;                               ///< Number of slots in this slab, header included.
+        } header;
+        alignas(T) unsigned char storage[sizeof(T)];   ///< Raw storage for one object.
+    };
+
+    using slot_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+    using slot_traits    = std::allocator_traits<slot_allocator>;
+
+    /**
+     * @brief The slabs carved by one pool; freed when the last reference goes away.
+     */
+    struct Arena {
+        Slot* slabs;          ///< List of slabs, most recent first.
+        slot_allocator alloc; ///< Allocator the slabs came from.
+
+        explicit Arena(const slot_allocator &a) : slabs(nullptr), alloc(a) {}
+        Arena(const Arena &) = delete;
+        Arena& operator=(const Arena &) = delete;
+        ~Arena() {
+            while (slabs) {
+                Slot* next = slabs->header.next_slab;
+                slot_traits::deallocate(alloc, slabs, slabs->header.size);
+                slabs = next;
+            }
+        }
+    };
+
+    using arena_ptr   = std::shared_ptr<Arena>;
+    using arena_list  = std::vector<arena_ptr,
+                                    typename std::allocator_traits<Allocator>::template rebind_alloc<arena_ptr>>;
+
+public:
+    /**
+     * @brief Keeps every arena a pool's objects may live in alive, e.g. for an extracted node.
+     */
+    struct Lease {
+        arena_ptr own;                       ///< The arena of the leasing pool.
+        std::shared_ptr<arena_list> adopted; ///< Arenas the leasing pool had adopted, or nullptr.
+    };
+
+private:
+    static constexpr size_t kFirstSlab = 32;   ///< Objects in the first slab.
+    static constexpr size_t kMaxSlab   = 4096; ///< Upper bound for the slab size growth.
+
+    arena_ptr own;                       ///< Slabs carved by this pool; created on first allocation.
+    std::shared_ptr<arena_list> adopted; ///< Arenas of other pools whose objects this pool holds, or nullptr.
+    Slot* free_list;      ///< Slots returned by deallocate().
+    Slot* bump;           ///< Next never-used slot in the most recent slab.
+    Slot* bump_end;       ///< End of the most recent slab.
+    size_t next_size;     ///< Number of objects in the next slab.
+    slot_allocator alloc; ///< Allocator for slabs.
+
+    /**
+     * @brief Adds @p a to the adopted arenas unless this pool already refers to it.
+     */
+    void adopt_arena(const arena_ptr &a) {
+        if (!a || a == own)
+            return;
+        if (!adopted)
+            adopted = std::allocate_shared<arena_list>(alloc, alloc);
+        if (std::find(adopted->begin(), adopted->end(), a) == adopted->end())
+            adopted->push_back(a);
+    }
+
+    /**
+     * @brief Allocates a new slab and makes it the bump region.
+     */
+    void grow() {
+        if (!own)
+            own = std::allocate_shared<Arena>(alloc, alloc);
+        size_t n = next_size + 1;
+        Slot* slab = slot_traits::allocate(own->alloc, n);
+        slab->header.next_slab = own->slabs;
+        slab->header.size = n;
+        own->slabs = slab;
+        bump = slab + 1;
+        bump_end = slab + n;
+        if (next_size < kMaxSlab)
+            next_size *= 2;
+    }
+
+public:
+    /**
+     * @brief Constructs an empty pool. No memory is allocated until the first allocate().
+     *
+     * @param a The allocator used for slabs.
+     */
+    explicit NodePool(const Allocator &a = Allocator())
+        : own(nullptr), adopted(nullptr), free_list(nullptr), bump(nullptr), bump_end(nullptr),
+          next_size(kFirstSlab), alloc(a) {}
+
+    NodePool(const NodePool &) = delete;
+    NodePool& operator=(const NodePool &) = delete;
+
+    /**
+     * @brief Move constructor. Takes over all slabs of @p other.
+     */
+    NodePool(NodePool &&other) noexcept
+        : own(std::move(other.own)), adopted(std::move(other.adopted)),
+          free_list(other.free_list), bump(other.bump), bump_end(other.bump_end),
+          next_size(other.next_size), alloc(std::move(other.alloc))
+    {
+        other.free_list = other.bump = other.bump_end = nullptr;
+        other.next_size = kFirstSlab;
+    }
+
+    /**
+     * @brief Move assignment. Releases this pool's slabs and takes over those of @p other.
+     */
+    NodePool& operator=(NodePool &&other) noexcept {
+        if (this != &other) {
+            release();
+            NodePool tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destructor. Returns every slab to the allocator.
+     */
+    ~NodePool() { release(); }
+
+    /**
+     * @brief Returns the allocator used for slabs, rebound to the object type.
+     */
+    Allocator get_allocator() const { return Allocator(alloc); }
+
+    /**
+     * @brief Obtains storage for one object.
+     *
+     * @return Pointer to uninitialized storage suitable for a T.
+     */
+    T* allocate() {
+        Slot* s;
+        if (free_list) {
+            s = free_list;
+            free_list = s->next_free;
+        } else {
+            if (bump == bump_end)
+                grow();
+            s = bump++;
+        }
+        return reinterpret_cast<T*>(s->storage);
+    }
+
+    /**
+     * @brief Makes sure the next @p n calls to allocate() do not throw.
+     *
+     * Adds slabs until the free list and the bump region hold at least @p n slots; the
+     * unused tail of a replaced bump region moves to the free list.
+     *
+     * @param n The number of allocations to prepare for.
+     */
+    void reserve(size_t n) {
+        size_t available = static_cast<size_t>(bump_end - bump);
+        while (available < n) {
+            for (; bump != bump_end; ++bump)
+                deallocate(reinterpret_cast<T*>(bump->storage));
+            grow();
+            available += static_cast<size_t>(bump_end - bump);
+        }
+    }
+
+    /**
+     * @brief Returns storage obtained from allocate() to the pool.
+     *
+     * @param p Pointer to storage whose object has already been destroyed.
+     */
+    void deallocate(T* p) noexcept {
+        Slot* s = reinterpret_cast<Slot*>(p);
+        s->next_free = free_list;
+        free_list = s;
+    }
+
+    /**
+     * @brief Drops this pool's storage, returning its slabs to the allocator.
+     *
+     * All objects held by the pool must already be destroyed. Slabs that objects now held
+     * by another pool or a lease still live in are freed once those release them too.
+     */
+    void release() noexcept {
+        own.reset();
+        adopted.reset();
+        free_list = bump = bump_end = nullptr;
+        next_size = kFirstSlab;
+    }
+
+    /**
+     * @brief Returns a lease on every arena this pool's objects may live in.
+     *
+     * Taking a lease does not allocate.
+     */
+    Lease lease() const { return Lease{own, adopted}; }
+
+    /**
+     * @brief Takes joint ownership of the arenas of a lease.
+     *
+     * Called before this pool takes over objects allocated by another pool, so that their
+     * storage stays valid for as long as this pool may hold them. Storage of adopted
+     * objects returned with deallocate() is reused by this pool.
+     *
+     * Allocates the list of adopted arenas on first use and grows it for each new arena;
+     * a lease whose arenas this pool already refers to adds nothing and does not allocate.
+     *
+     * @param l A lease from the pool the objects come from.
+     * @throws std::bad_alloc If the list cannot grow. Arenas adopted before the failure stay
+     *         adopted, which only keeps them alive longer.
+     */
+    void adopt(const Lease &l) {
+        adopt_arena(l.own);
+        if (l.adopted && l.adopted != adopted)
+            for (const arena_ptr &a : *l.adopted)
+                adopt_arena(a);
+    }
+
+    /**
+     * @brief Swaps the contents of this pool with another.
+     */
+    void swap(NodePool &other) noexcept {
+        std::swap(own, other.own);
+        std::swap(adopted, other.adopted);
+        std::swap(free_list, other.free_list);
+        std::swap(bump, other.bump);
+        std::swap(bump_end, other.bump_end);
+        std::swap(next_size, other.next_size);
+        std::swap(alloc, other.alloc);
+    }
+};
+
+}
+#endif // NODE_POOL_HPP_
@@ -0,0 +1,96 @@
+#ifndef MGC_PARALLEL_HPP_
+#define MGC_PARALLEL_HPP_
+
+#include <algorithm>    // for std::for_each, std::min
+#include <concepts>     // for std::convertible_to
+#include <cstddef>      // for size_t
+#include <execution>    // for std::execution::par
+#include <numeric>      // for std::iota
+#include <utility>      // for std::move
+#include <vector>       // for std::vector
+
+namespace mgc {
+
+/**
+ * @brief Satisfied by maps whose elements can be scanned in independent position ranges.
+ *
+ * scan_extent() is the number of positions and for_each_in(first, last, f) visits the
+ * elements stored at positions [first, last). HashMap (buckets), FlatHashMap (slots) and
+ * DenseHashMap (array positions) model it.
+ */
+template<typename M>
+concept splittable_map = requires(const M &m, void (*f)(const typename M::value_type &)) {
+    { m.scan_extent() } -> std::convertible_to<size_t>;
+    m.for_each_in(size_t{0}, size_t{0}, f);
+};
+
+namespace detail {
+
+/// Number of positions handled by one parallel task.
+inline constexpr size_t kScanGrain = 1024;
+
+/**
+ * @brief Runs @p task(first, last) for every grain-sized chunk of [0, n), in parallel.
+ *
+ * @return The number of chunks; chunk c covers [c * kScanGrain, min(n, (c + 1) * kScanGrain)).
+ */
+template<typename Task>
+size_t parallel_chunks(size_t n, Task &&task) {
+    std::vector<size_t> chunks((n + kScanGrain - 1) / kScanGrain);
+    std::iota(chunks.begin(), chunks.end(), size_t{0});
+    std::for_each(std::execution::par, chunks.begin(), chunks.end(), [n, &task](size_t c) {
+        task(c, c * kScanGrain, std::min(n, (c + 1) * kScanGrain));
+    });
+    return chunks.size();
+}
+
+} // namespace detail
+
+/**
+ * @brief Calls @p f on every element of @p map, splitting the scan across threads.
+ *
+ * @p f may run concurrently for different elements, so it must be thread-safe. The map
+ * must not be modified during the call.
+ *
+ * @param map The map to scan.
+ * @param f   Callback invoked as f(const value_type&).
+ */
+template<splittable_map Map, typename F>
+void parallel_for_each(const Map &map, F &&f) {
+    detail::parallel_chunks(map.scan_extent(), [&map, &f](size_t, size_t first, size_t last) {
+        map.for_each_in(first, last, f);
+    });
+}
+
+/**
+ * @brief Maps every element of @p map to a T and combines the results, in parallel.
+ *
+ * Every task folds its own chunk into a private accumulator, so @p transform and @p reduce
+ * need no synchronization. The per-task results are then combined in storage (position)
+ * order, which is deterministic for a given table state, so even a non-commutative
+ * @p reduce (e.g. string concatenation) gives the same result on every call. Storage order
+ * is not iteration order for HashMap, whose iterators follow insertion order.
+ *
+ * @param map       The map to scan. It must not be modified during the call.
+ * @param identity  Neutral element of @p reduce; every accumulator starts from it.
+ * @param transform Invoked as transform(const value_type&), returns a T.
+ * @param reduce    Associative combination, invoked as reduce(T, T), returns a T.
+ * @return The combination of all transformed elements, or @p identity for an empty map.
+ */
+template<splittable_map Map, typename T, typename Transform, typename Reduce>
+T parallel_reduce(const Map &map, T identity, Transform transform, Reduce reduce) {
+    const size_t n = map.scan_extent();
+    std::vector<T> partial((n + detail::kScanGrain - 1) / detail::kScanGrain, identity);
+    detail::parallel_chunks(n, [&](size_t c, size_t first, size_t last) {
+        T acc = identity;
+        map.for_each_in(first, last, [&](const auto &kv) { acc = reduce(std::move(acc), transform(kv)); });
+        partial[c] = std::move(acc);
+    });
+    T result = std::move(identity);
+    for (T &p : partial)
+        result = reduce(std::move(result), std::move(p));
+    return result;
+}
+
+}
+#endif // MGC_PARALLEL_HPP_
@@ -0,0 +1,330 @@
+#ifndef RCU_HASH_MAP_HPP_
+#define RCU_HASH_MAP_HPP_
+
+#include <atomic>       // for std::atomic
+#include <functional>   // for std::hash
+#include <mutex>        // for std::mutex, std::lock_guard
+#include <optional>     // for std::optional
+#include <utility>      // for std::pair
+#include <vector>       // for std::vector
+#include "epoch.hpp"
+#include "hash.hpp"
+
+namespace mgc {
+
+/**
+ * @brief A read-optimized hash map whose lookups never lock or block.
+ *
+ * Separate chaining like mgc::HashMap, but every bucket head and chain link is an atomic
+ * pointer and a published node is never modified. Readers pin an epoch (see
+ * mgc::EpochDomain) and walk the chains without any lock, even while a writer inserts,
+ * erases or grows the table. Writers are serialized by one mutex and publish every change
+ * with a single atomic store:
+ *
+ * - insert links a new node at the bucket head;
+ * - an update links a replacement node in place of the old one;
+ * - erase links the predecessor past the node;
+ * - growth builds a complete new table and swaps the table pointer.
+ *
+ * Unlinked nodes and old tables are retired and freed once no reader can still see them.
+ * Readers obtain values by copy (find) or through a callback invoked while pinned (visit),
+ * never through references that could outlive the pin. Intended for workloads dominated
+ * by lookups; each write allocates, and growth copies every element.
+ *
+ * @tparam Key      The key type. Must be copy constructible.
+ * @tparam Value    The mapped value type. Must be copy constructible.
+ * @tparam Hash     The hash function object type. Defaults to std::hash<Key>.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class RcuHashMap {
+public:
+    /// The type of key-value pair stored in the map.
+    using value_type = std::pair<const Key, Value>;
+
+private:
+    /**
+     * @brief Immutable chain node.
+     */
+    struct Node {
+        const value_type kv;      ///< The key-value pair; never modified after publication.
+        const size_t hash;        ///< Cached hash of the key, so growth does not rehash.
+        std::atomic<Node*> next;  ///< Next node in the bucket chain.
+
+        Node(const value_type &p, size_t h, Node* n) : kv(p), hash(h), next(n) {}
+    };
+
+    /**
+     * @brief Bucket array published as a unit.
+     */
+    struct Table {
+        size_t capacity;                 ///< Number of buckets.
+        std::atomic<Node*>* buckets;     ///< Bucket heads.
+
+        explicit Table(size_t cap) : capacity(cap), buckets(new std::atomic<Node*>[cap]) {
+            for (size_t i = 0; i < cap; ++i)
+                buckets[i].store(nullptr, std::memory_order_relaxed);
+        }
+        ~Table() { delete[] buckets; }
+    };
+
+    /**
+     * @brief An object waiting for readers to move on before it is freed.
+     */
+    struct Retired {
+        Node* node;      ///< Retired node, or nullptr.
+        Table* table;    ///< Retired table (its buckets only; the nodes are retired separately), or nullptr.
+        uint64_t epoch;  ///< Global epoch when it was retired.
+    };
+
+    std::atomic<Table*> table;       ///< Currently published table.
+    std::atomic<size_t> count;       ///< Number of elements stored.
+    std::mutex write_mtx;            ///< Serializes writers.
+    std::vector<Retired> retired;    ///< Objects awaiting reclamation; guarded by write_mtx.
+    Hash hashFunc;                   ///< Hash function object.
+    double max_load;                 ///< Maximum load factor threshold before growing.
+    EpochDomain &domain;             ///< Reclamation domain shared with readers.
+
+    /**
+     * @brief Finds the link that points to the node holding @p key in the current table.
+     *
+     * Writer side only: write_mtx must be held.
+     */
+    template<typename K>
+    std::atomic<Node*>* find_link(Table* t, const K &key, size_t hash) const {
+        std::atomic<Node*>* link = &t->buckets[hash % t->capacity];
+        for (Node* cur = link->load(std::memory_order_relaxed); cur; cur = link->load(std::memory_order_relaxed)) {
+            if (cur->hash == hash && cur->kv.first == key)
+                return link;
+            link = &cur->next;
+        }
+        return nullptr;
+    }
+
+    /*
+     * Retirement tags an object with the epoch read after it was unlinked. Publishing stores
+     * are seq_cst so that the unlink cannot be reordered after that read.
+     */
+    void retire(Node* n) { retired.push_back({n, nullptr, domain.current()}); }
+    void retire(Table* t) { retired.push_back({nullptr, t, domain.current()}); }
+
+    /**
+     * @brief Frees retired objects that no reader can reach any more.
+     */
+    void collect() {
+        domain.try_advance();
+        size_t kept = 0;
+        for (const Retired &r : retired) {
+            if (domain.safe_to_reclaim(r.epoch)) {
+                delete r.node;
+                delete r.table;
+            } else {
+                retired[kept++] = r;
+            }
+        }
+        retired.resize(kept);
+    }
+
+    /**
+     * @brief Publishes a table twice as large holding copies of every node.
+     *
+     * Readers still walking the old table keep seeing consistent chains; the old nodes
+     * and buckets are retired together.
+     */
+    void grow(Table* old) {
+        Table* fresh = new Table(old->capacity * 2 + 1);
+        for (size_t i = 0; i < old->capacity; ++i) {
+            for (Node* cur = old->buckets[i].load(std::memory_order_relaxed); cur;
+                 cur = cur->next.load(std::memory_order_relaxed)) {
+                std::atomic<Node*> &head = fresh->buckets[cur->hash % fresh->capacity];
+                head.store(new Node(cur->kv, cur->hash, head.load(std::memory_order_relaxed)),
+                           std::memory_order_relaxed);
+            }
+        }
+        table.store(fresh, std::memory_order_seq_cst);
+        retire_all(old);
+    }
+
+    /**
+     * @brief Retires an unpublished table together with every node reachable from it.
+     */
+    void retire_all(Table* old) {
+        for (size_t i = 0; i < old->capacity; ++i)
+            for (Node* cur = old->buckets[i].load(std::memory_order_relaxed); cur;
+                 cur = cur->next.load(std::memory_order_relaxed))
+                retire(cur);
+        retire(old);
+    }
+
+    /**
+     * @brief Frees a table and every node reachable from it. No reader may be active on it.
+     */
+    static void destroy(Table* t) {
+        for (size_t i = 0; i < t->capacity; ++i) {
+            Node* cur = t->buckets[i].load(std::memory_order_relaxed);
+            while (cur) {
+                Node* nxt = cur->next.load(std::memory_order_relaxed);
+                delete cur;
+                cur = nxt;
+            }
+        }
+        delete t;
+    }
+
+public:
+    /**
+     * @brief Constructs an empty RcuHashMap.
+     *
+     * @param init_cap Initial number of buckets (default is 11).
+     * @param load     Maximum load factor before growing (default is 1.0).
+     */
+    explicit RcuHashMap(size_t init_cap = 11, double load = 1.0)
+        : table(new Table(init_cap ? init_cap : 1)), count(0), max_load(load), domain(EpochDomain::instance()) {}
+
+    RcuHashMap(const RcuHashMap &) = delete;
+    RcuHashMap& operator=(const RcuHashMap &) = delete;
+
+    /**
+     * @brief Destructor. No reader or writer may be using the map any more.
+     */
+    ~RcuHashMap() {
+        for (const Retired &r : retired) {
+            delete r.node;
+            delete r.table;
+        }
+        destroy(table.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Returns the number of elements in the map.
+     */
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns a copy of the value associated with a key. Never blocks.
+     *
+     * @param key The key to search for.
+     * @return The value, or std::nullopt if the key is absent.
+     */
+    template<typename K>
+    std::optional<Value> find(const K &key) const {
+        std::optional<Value> result;
+        visit(key, [&result](const value_type &kv) { result.emplace(kv.second); });
+        return result;
+    }
+
+    /**
+     * @brief Checks whether an element with the given key exists. Never blocks.
+     *
+     * @param key The key to search for.
+     * @return true if the key is present.
+     */
+    template<typename K>
+    bool contains(const K &key) const { return visit(key, [](const value_type &) {}); }
+
+    /**
+     * @brief Calls @p f on the element with the given key while the calling thread is pinned. Never blocks.
+     *
+     * The reference passed to @p f is only valid during the call.
+     *
+     * @param key The key to search for.
+     * @param f   Callback invoked as f(const value_type&).
+     * @return true if the key was found and @p f was called.
+     */
+    template<typename K, typename F>
+    bool visit(const K &key, F &&f) const {
+        EpochDomain::Guard guard(domain);
+        size_t hash = hashFunc(key);
+        const Table* t = table.load(std::memory_order_acquire);
+        for (const Node* cur = t->buckets[hash % t->capacity].load(std::memory_order_acquire); cur;
+             cur = cur->next.load(std::memory_order_acquire)) {
+            if (cur->hash == hash && cur->kv.first == key) {
+                f(cur->kv);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Inserts a key-value pair, or replaces the value if the key already exists.
+     *
+     * @param key   The key to insert.
+     * @param value The value associated with the key.
+     * @return true if a new element was inserted.
+     */
+    bool insert(const Key &key, const Value &value) {
+        std::lock_guard lock(write_mtx);
+        size_t hash = hashFunc(key);
+        Table* t = table.load(std::memory_order_relaxed);
+        bool inserted;
+        if (std::atomic<Node*>* link = find_link(t, key, hash)) {
+            Node* old = link->load(std::memory_order_relaxed);
+            link->store(new Node(value_type(key, value), hash, old->next.load(std::memory_order_relaxed)),
+                        std::memory_order_seq_cst);
+            retire(old);
+            inserted = false;
+        } else {
+            std::atomic<Node*> &head = t->buckets[hash % t->capacity];
+            head.store(new Node(value_type(key, value), hash, head.load(std::memory_order_relaxed)),
+                       std::memory_order_seq_cst);
+            count.fetch_add(1, std::memory_order_relaxed);
+            if (static_cast<double>(size()) > static_cast<double>(t->capacity) * max_load)
+                grow(t);
+            inserted = true;
+        }
+        collect();
+        return inserted;
+    }
+
+    /**
+     * @brief Erases the element with the given key.
+     *
+     * @param key The key of the element to erase.
+     * @return true if an element was erased.
+     */
+    template<typename K>
+    bool erase(const K &key) {
+        std::lock_guard lock(write_mtx);
+        size_t hash = hashFunc(key);
+        std::atomic<Node*>* link = find_link(table.load(std::memory_order_relaxed), key, hash);
+        if (!link)
+            return false;
+        Node* victim = link->load(std::memory_order_relaxed);
+        link->store(victim->next.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+        retire(victim);
+        count.fetch_sub(1, std::memory_order_relaxed);
+        collect();
+        return true;
+    }
+
+    /**
+     * @brief Removes every element by publishing an empty table of the same size.
+     */
+    void clear() {
+        std::lock_guard lock(write_mtx);
+        Table* old = table.load(std::memory_order_relaxed);
+        table.store(new Table(old->capacity), std::memory_order_seq_cst);
+        retire_all(old);
+        count.store(0, std::memory_order_relaxed);
+        collect();
+    }
+
+    /**
+     * @brief Returns the number of retired objects not yet freed (for tests and diagnostics).
+     */
+    size_t pending_reclamation() {
+        std::lock_guard lock(write_mtx);
+        return retired.size();
+    }
+
+    /**
+     * @brief Frees whatever retired objects have become unreachable.
+     */
+    void reclaim() {
+        std::lock_guard lock(write_mtx);
+        collect();
+    }
+};
+
+}
+#endif // RCU_HASH_MAP_HPP_
@@ -0,0 +1,131 @@
+#ifndef STRING_POOL_HPP_
+#define STRING_POOL_HPP_
+
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint32_t
+#include <deque>        // for std::deque
+#include <mutex>        // for std::unique_lock
+#include <shared_mutex> // for std::shared_mutex, std::shared_lock
+#include <string>       // for std::string
+#include <string_view>  // for std::string_view
+#include "flat_hash_map.hpp"
+#include "hash.hpp"
+
+namespace mgc {
+
+class StringPool;
+
+/**
+ * @brief A handle to a string stored once in a StringPool.
+ *
+ * Eight bytes, trivially copyable. Two handles from the same pool are equal exactly when
+ * their strings are equal, so comparing them is a single pointer compare. The
+ * default-constructed handle is the empty string and needs no pool.
+ */
+class InternedString {
+    friend class StringPool;
+
+    /**
+     * @brief One pooled string; never moved or freed while the pool lives.
+     */
+    struct Entry {
+        std::string text; ///< The characters.
+        uint32_t id;      ///< Dense index of the string in its pool.
+    };
+
+    const Entry* entry = nullptr; ///< The pooled string, or nullptr for the empty string.
+
+    explicit InternedString(const Entry* e) : entry(e) {}
+
+public:
+    InternedString() = default;
+
+    /**
+     * @brief Returns the characters.
+     */
+    std::string_view view() const noexcept { return entry ? std::string_view(entry->text) : std::string_view(); }
+
+    /**
+     * @brief Returns a dense index (0, 1, 2, ... in order of first interning) usable to index
+     *        per-string arrays. The empty string is always 0.
+     */
+    uint32_t id() const noexcept { return entry ? entry->id : 0; }
+
+    operator std::string_view() const noexcept { return view(); }
+
+    friend bool operator==(InternedString a, InternedString b) noexcept { return a.entry == b.entry; }
+};
+
+/**
+ * @brief Interning dictionary: stores every distinct string once.
+ *
+ * intern() returns a handle to the single stored copy of its argument. Handles stay valid
+ * for the lifetime of the pool and strings are never removed, so a pool suits small,
+ * recurring vocabularies such as manufacturer or country names, not unique text.
+ *
+ * Thread-safe: lookups of already interned strings share a reader lock, and only the first
+ * interning of a string takes the writer lock. Reading a handle never locks.
+ */
+class StringPool {
+    using Entry = InternedString::Entry;
+
+    std::deque<Entry> entries;                                     ///< Stored strings; a deque never moves them.
+    FlatHashMap<std::string_view, const Entry*, string_hash> index; ///< Views into entries, for lookup.
+    mutable std::shared_mutex mtx;                                 ///< Guards entries and index.
+
+public:
+    StringPool() = default;
+
+    StringPool(const StringPool &) = delete;
+    StringPool& operator=(const StringPool &) = delete;
+
+    /**
+     * @brief Returns the process-wide pool.
+     */
+    static StringPool& global() {
+        static StringPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief Returns the handle of a string, storing the string if it is new.
+     *
+     * @param s The string to intern.
+     * @return A handle equal to every other handle of the same string from this pool.
+     */
+    InternedString intern(std::string_view s) {
+        if (s.empty())
+            return InternedString();
+        {
+            std::shared_lock lock(mtx);
+            auto pos = index.find(s);
+            if (pos != index.end())
+                return InternedString(pos->second);
+        }
+        std::unique_lock lock(mtx);
+        auto pos = index.find(s);
+        if (pos != index.end())
+            return InternedString(pos->second);
+        // Id 0 is the empty string, which is never stored.
+        const Entry &e = entries.emplace_back(Entry{std::string(s), static_cast<uint32_t>(entries.size() + 1)});
+        try {
+            index.try_emplace(std::string_view(e.text), &e);
+        } catch (...) {
+            // An entry missing from the index would be stored again under a second id.
+            entries.pop_back();
+            throw;
+        }
+        return InternedString(&e);
+    }
+
+    /**
+     * @brief Returns the number of distinct strings, including the empty string.
+     */
+    size_t size() const {
+        std::shared_lock lock(mtx);
+        return entries.size() + 1;
+    }
+};
+
+}
+#endif // STRING_POOL_HPP_
@@ -1,31 +1,86 @@
 #ifndef UNORDERED_MAP_HPP_
 #define UNORDERED_MAP_HPP_
 
+#include <algorithm>    // for std::min
+#include <concepts>     // for std::constructible_from
+#include <cmath>        // for std::ceil
 #include <functional>   // for std::hash
+#include <initializer_list> // for std::initializer_list
+#include <memory>       // for std::allocator, std::construct_at, std::destroy_at
+#include <ranges>       // for std::ranges::random_access_range, std::ranges::size
 #include <stdexcept>    // for std::out_of_range
-#include <utility>      // for std::pair, std::move, std::swap
-#include <iterator>     // for std::bidirectional_iterator_tag
+#include <type_traits>  // for std::is_empty_v, std::is_nothrow_copy_constructible_v, std::is_nothrow_move_constructible_v
+#include <tuple>        // for std::forward_as_tuple
+#include <utility>      // for std::pair, std::move, std::swap, std::piecewise_construct, std::as_const
+#include <iterator>     // for std::bidirectional_iterator_tag, std::input_iterator, std::distance
+#include "bucket_policy.hpp"
+#include "hash.hpp"
+#include "node_pool.hpp"
 
 namespace mgc {
 
+namespace detail {
+
+/**
+ * @brief Storage for a node's cached hash; empty when hashes are not cached.
+ */
+template<bool Enabled>
+struct cached_hash {
+    void set(size_t) {}
+    bool may_match(size_t) const { return true; }
+};
+
+template<>
+struct cached_hash<true> {
+    size_t value = 0; ///< The full hash of the node's key.
+
+    void set(size_t h) { value = h; }
+    bool may_match(size_t h) const { return value == h; }
+};
+
+} // namespace detail
+
 /**
  * @brief A hash map implementation using separate chaining.
  *
  * This template class implements a hash map similar to std::unordered_map.
  * It uses separate chaining (via a linked list in each bucket) to resolve collisions.
  * Additionally, it maintains a global doubly linked list of nodes to support bidirectional iteration.
+ * Nodes are carved out of slabs owned by the map (see mgc::NodePool), so inserts and erases
+ * reuse pooled storage instead of calling the global allocator for every element.
+ * If Hash is transparent (see mgc::transparent_hash), find/contains/erase also accept
+ * any key-like type that the hash and Key's operator== accept.
+ *
+ * Growth normally relinks every node at once. With set_incremental_rehash(true) the map
+ * instead keeps the old bucket array alive and migrates a few buckets on every mutation,
+ * so no single insert pays for the whole table.
+ *
+ * How a hash selects a bucket is a compile-time policy (see bucket_policy.hpp); the
+ * default modulo_policy keeps the historical odd bucket counts, pow2_mask_policy and
+ * fastrange_policy avoid the division. Pair them with seeded_string_hash when keys come
+ * from untrusted input.
  *
- * @tparam Key      The key type. Must be default constructible.
- * @tparam Value    The mapped value type. Must be default constructible.
- * @tparam Hash     The hash function object type. Defaults to std::hash<Key>.
+ * Unless mgc::cache_hash says otherwise, every node also stores the full hash of its key,
+ * so rehashing never calls the hasher and lookups skip key comparisons on hash mismatch.
+ *
+ * @tparam Key       The key type. Must be default constructible.
+ * @tparam Value     The mapped value type. Must be default constructible.
+ * @tparam Hash      The hash function object type. Defaults to std::hash<Key>.
+ * @tparam Policy    The bucket indexing policy. Defaults to mgc::modulo_policy.
+ * @tparam Allocator The allocator the node pool obtains its slabs from.
  */
-template<typename Key, typename Value, typename Hash = std::hash<Key>>
+template<typename Key, typename Value, typename Hash = std::hash<Key>,
+         typename Policy = modulo_policy,
+         typename Allocator = std::allocator<std::pair<const Key, Value>>>
 class HashMap {
 public:
     /// The type of key-value pair stored in the map.
     using value_type = std::pair<const Key, Value>;
 
 private:
+    /// Whether nodes store the hash of their key (see mgc::cache_hash).
+    static constexpr bool kCacheHash = cache_hash<Key, Hash>::value;
+
     /**
      * @brief Internal node structure.
      *
@@ -37,15 +92,16 @@ private:
         Node* bucket_next;///< Pointer to the next node in the same bucket.
         Node* next;       ///< Pointer to the next node in the global list.
         Node* prev;       ///< Pointer to the previous node in the global list.
+        [[no_unique_address]] detail::cached_hash<kCacheHash> hash; ///< Hash of the key, if cached.
 
         /**
-         * @brief Constructs a Node with the given key and value.
+         * @brief Constructs a Node whose key-value pair is built in place.
          *
-         * @param key   The key.
-         * @param value The value.
+         * @param args Arguments forwarded to the std::pair constructor.
          */
-        Node(const Key &key, const Value &value)
-            : kv(key, value), bucket_next(nullptr), next(nullptr), prev(nullptr) {}
+        template<typename... Args>
+        explicit Node(Args&&... args)
+            : kv(std::forward<Args>(args)...), bucket_next(nullptr), next(nullptr), prev(nullptr) {}
     };
 
     Node** buckets;      ///< Dynamic array of bucket pointers.
@@ -55,32 +111,339 @@ private:
     Node* tail;          ///< Tail of the global doubly linked list of nodes.
     Hash hashFunc;       ///< Hash function object.
     double max_load;     ///< Maximum load factor threshold before rehashing.
+    NodePool<Node, Allocator> pool; ///< Slab storage for nodes.
+    Node** old_buckets;  ///< Bucket array being migrated by an incremental rehash, or nullptr.
+    size_t old_capacity; ///< Number of buckets in old_buckets.
+    size_t migrate_pos;  ///< Old buckets below this index have already been migrated.
+    bool incremental;    ///< Whether growth uses incremental rehashing.
+
+    /// Number of old buckets migrated per mutation during an incremental rehash.
+    static constexpr size_t kRehashStep = 4;
+
+    /// Number of keys hashed and prefetched together by visit_many().
+    static constexpr size_t kPrefetchBatch = 16;
+
+    /**
+     * @brief Allocates a bucket array with every bucket empty.
+     *
+     * @param n The number of buckets.
+     * @return The new bucket array.
+     */
+    static Node** allocate_buckets(size_t n) {
+        Node** b = new Node*[n];
+        for (size_t i = 0; i < n; ++i)
+            b[i] = nullptr;
+        return b;
+    }
+
+    /**
+     * @brief Creates a node in pooled storage.
+     *
+     * @param args Arguments forwarded to the key-value pair constructor.
+     * @return Pointer to the new node.
+     */
+    template<typename... Args>
+    Node* create_node(Args&&... args) {
+        Node* n = pool.allocate();
+        try {
+            std::construct_at(n, std::forward<Args>(args)...);
+        } catch (...) {
+            pool.deallocate(n);
+            throw;
+        }
+        return n;
+    }
+
+    /**
+     * @brief Destroys a node and returns its storage to the pool.
+     *
+     * @param n The node to destroy.
+     */
+    void destroy_node(Node* n) {
+        std::destroy_at(n);
+        pool.deallocate(n);
+    }
+
+    /**
+     * @brief Resolves a batch of keys in three passes so that their cache misses overlap.
+     *
+     * Blocks of kPrefetchBatch keys are hashed and their bucket heads prefetched, then the
+     * first node of every chain is prefetched, and only then are the chains walked.
+     *
+     * @param self The map (const or not), which selects the iterator type passed to @p f.
+     * @param keys Random-access range of keys.
+     * @param f    Callback invoked as f(index, iterator) for every key, in order.
+     */
+    template<typename Self, typename R, typename F>
+    static void visit_many_impl(Self &self, R &keys, F &f) {
+        using It = decltype(self.end());
+        const size_t n = std::ranges::size(keys);
+        auto first = std::ranges::begin(keys);
+        size_t hashes[kPrefetchBatch];
+        size_t bucket_idx[kPrefetchBatch];
+        for (size_t base = 0; base < n; base += kPrefetchBatch) {
+            const size_t m = std::min(kPrefetchBatch, n - base);
+            for (size_t j = 0; j < m; ++j) {
+                hashes[j] = self.hashFunc(first[base + j]);
+                bucket_idx[j] = Policy::index(hashes[j], self.capacity);
+                __builtin_prefetch(&self.buckets[bucket_idx[j]]);
+            }
+            for (size_t j = 0; j < m; ++j)
+                if (Node* head = self.buckets[bucket_idx[j]])
+                    __builtin_prefetch(head);
+            for (size_t j = 0; j < m; ++j) {
+                Node** link = self.find_link(first[base + j], hashes[j]);
+                f(base + j, It(link ? *link : nullptr, &self));
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the hash of a linked node's key, from the cache if there is one.
+     */
+    size_t node_hash(const Node* n) const {
+        if constexpr (kCacheHash)
+            return n->hash.value;
+        else
+            return hashFunc(n->kv.first);
+    }
+
+    /**
+     * @brief Finds the link pointing to the node holding a key.
+     *
+     * While an incremental rehash is in progress, buckets of the old array that
+     * have not been migrated yet are searched as well.
+     *
+     * @tparam K Key or a type comparable with Key (heterogeneous lookup).
+     * @param key  The key to search for.
+     * @param hash The hash of @p key.
+     * @return Pointer to the bucket head or bucket_next field that points to the node, or nullptr if not found.
+     */
+    template<typename K>
+    Node** find_link(const K &key, size_t hash) const {
+        for (Node** link = &buckets[Policy::index(hash, capacity)]; *link; link = &(*link)->bucket_next)
+            if ((*link)->hash.may_match(hash) && (*link)->kv.first == key)
+                return link;
+        if (old_buckets && Policy::index(hash, old_capacity) >= migrate_pos) {
+            for (Node** link = &old_buckets[Policy::index(hash, old_capacity)]; *link; link = &(*link)->bucket_next)
+                if ((*link)->hash.may_match(hash) && (*link)->kv.first == key)
+                    return link;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Looks up the node holding a key.
+     *
+     * @tparam K Key or a type comparable with Key (heterogeneous lookup).
+     * @param key The key to search for.
+     * @return Pointer to the node, or nullptr if not found.
+     */
+    template<typename K>
+    Node* find_node(const K &key) const {
+        Node** link = find_link(key, hashFunc(key));
+        return link ? *link : nullptr;
+    }
+
+    /**
+     * @brief Links a new node into its bucket and the global list, then grows the table if needed.
+     *
+     * @param n    The new node.
+     * @param hash The hash of the node's key.
+     */
+    void link_node(Node* n, size_t hash) {
+        n->hash.set(hash);
+        // Insert into the bucket chain.
+        size_t idx = Policy::index(hash, capacity);
+        n->bucket_next = buckets[idx];
+        buckets[idx] = n;
+        // Append to the global doubly linked list.
+        n->prev = tail;
+        n->next = nullptr;
+        if (tail)
+            tail->next = n;
+        else
+            head = n;
+        tail = n;
+        ++count;
+        if (old_buckets)
+            rehash_step();
+        // Trigger rehashing if load factor exceeded.
+        if (load_factor() > max_load) {
+            if (incremental)
+                start_rehash(Policy::next_capacity(capacity));
+            else
+                rehash_internal(Policy::next_capacity(capacity));
+        }
+    }
+
+    /**
+     * @brief Returns the node for a key, building one in place from @p args if the key is absent.
+     *
+     * The key is hashed and searched once; it is only converted to Key when a node is created.
+     *
+     * @tparam K Key or a type Key can be constructed from.
+     * @param key  The key to search for.
+     * @param args Arguments forwarded to the Value constructor of a new node.
+     * @return The node and true if it was newly inserted.
+     */
+    template<typename K, typename... Args>
+    std::pair<Node*, bool> try_emplace_node(K &&key, Args&&... args) {
+        size_t hash = hashFunc(key);
+        if (Node** link = find_link(key, hash))
+            return {*link, false};
+        Node* n = create_node(std::piecewise_construct,
+                              std::forward_as_tuple(std::forward<K>(key)),
+                              std::forward_as_tuple(std::forward<Args>(args)...));
+        link_node(n, hash);
+        return {n, true};
+    }
+
+    /**
+     * @brief Inserts a value for a key, or assigns it to the existing element.
+     *
+     * @return The node and true if it was newly inserted.
+     */
+    template<typename K, typename M>
+    std::pair<Node*, bool> insert_or_assign_node(K &&key, M &&obj) {
+        size_t hash = hashFunc(key);
+        if (Node** link = find_link(key, hash)) {
+            (*link)->kv.second = std::forward<M>(obj);
+            return {*link, false};
+        }
+        Node* n = create_node(std::forward<K>(key), std::forward<M>(obj));
+        link_node(n, hash);
+        return {n, true};
+    }
+
+    /**
+     * @brief Unlinks and destroys the node holding a key, if any.
+     *
+     * @tparam K Key or a type comparable with Key (heterogeneous lookup).
+     * @param key The key of the element to erase.
+     */
+    template<typename K>
+    void erase_key(const K &key) {
+        if (old_buckets)
+            rehash_step();
+        if (Node** link = find_link(key, hashFunc(key)))
+            destroy_node(unlink(link));
+    }
+
+    /**
+     * @brief Removes a node from its bucket chain and the global list without destroying it.
+     *
+     * @param link The bucket head or bucket_next field that points to the node.
+     * @return The unlinked node.
+     */
+    Node* unlink(Node** link) {
+        Node* cur = *link;
+        // Remove from bucket chain.
+        *link = cur->bucket_next;
+        // Remove from global doubly linked list.
+        if (cur->prev)
+            cur->prev->next = cur->next;
+        else
+            head = cur->next;
+        if (cur->next)
+            cur->next->prev = cur->prev;
+        else
+            tail = cur->prev;
+        --count;
+        return cur;
+    }
+
+    /// Whether a hash cached by another map of this type is valid here; true for stateless hashers.
+    static constexpr bool kPortableHash = kCacheHash && std::is_empty_v<Hash>;
+
+    /**
+     * @brief Returns the hash this map uses for a node that was linked into another map.
+     */
+    size_t foreign_hash(const Node* n) const {
+        if constexpr (kPortableHash)
+            return n->hash.value;
+        else
+            return hashFunc(n->kv.first);
+    }
+
+    /**
+     * @brief Returns the smallest bucket count that holds @p n elements without exceeding max_load.
+     */
+    size_t min_buckets(size_t n) const {
+        return static_cast<size_t>(std::ceil(static_cast<double>(n) / max_load));
+    }
 
     /**
      * @brief Internal rehash function.
      *
-     * Rebuilds the hash table with a new bucket capacity.
+     * Rebuilds the hash table with a new bucket capacity in one pass,
+     * completing any incremental rehash in progress.
      *
-     * @param new_cap The new number of buckets.
+     * @param new_cap The new number of buckets, rounded to a count valid for the policy.
      */
     void rehash_internal(size_t new_cap) {
-        // Allocate a new bucket array and initialize pointers.
-        Node** new_buckets = new Node*[new_cap];
-        for (size_t i = 0; i < new_cap; ++i)
-            new_buckets[i] = nullptr;
+        new_cap = Policy::round_capacity(new_cap);
+        Node** new_buckets = allocate_buckets(new_cap);
 
         // Reassign each node to a new bucket.
         for (Node* cur = head; cur; cur = cur->next) {
-            size_t idx = hashFunc(cur->kv.first) % new_cap;
+            size_t idx = Policy::index(node_hash(cur), new_cap);
             cur->bucket_next = new_buckets[idx];
             new_buckets[idx] = cur;
         }
-        // Free the old bucket array and update member variables.
+        // Free the old bucket arrays and update member variables.
         delete[] buckets;
+        delete[] old_buckets;
+        old_buckets = nullptr;
+        old_capacity = migrate_pos = 0;
         buckets = new_buckets;
         capacity = new_cap;
     }
 
+    /**
+     * @brief Begins an incremental rehash.
+     *
+     * The current bucket array becomes the old array and a new, empty array takes its place.
+     * New nodes go to the new array; existing ones are moved over by rehash_step().
+     *
+     * @param new_cap The new number of buckets.
+     */
+    void start_rehash(size_t new_cap) {
+        // A previous migration that has not finished yet is completed first.
+        while (old_buckets)
+            rehash_step();
+        old_buckets = buckets;
+        old_capacity = capacity;
+        migrate_pos = 0;
+        buckets = allocate_buckets(new_cap);
+        capacity = new_cap;
+    }
+
+    /**
+     * @brief Migrates up to kRehashStep old buckets into the new bucket array.
+     *
+     * Frees the old array once every bucket has been moved.
+     */
+    void rehash_step() {
+        size_t end = std::min(migrate_pos + kRehashStep, old_capacity);
+        for (; migrate_pos < end; ++migrate_pos) {
+            Node* cur = old_buckets[migrate_pos];
+            while (cur) {
+                Node* nxt = cur->bucket_next;
+                size_t idx = Policy::index(node_hash(cur), capacity);
+                cur->bucket_next = buckets[idx];
+                buckets[idx] = cur;
+                cur = nxt;
+            }
+            old_buckets[migrate_pos] = nullptr;
+        }
+        if (migrate_pos == old_capacity) {
+            delete[] old_buckets;
+            old_buckets = nullptr;
+            old_capacity = migrate_pos = 0;
+        }
+    }
+
 public:
     /**
      * @brief Const bidirectional iterator for HashMap.
@@ -304,20 +667,145 @@ public:
         friend class HashMap;
     };
 
+    /**
+     * @brief Owning handle to a node extracted from a HashMap.
+     *
+     * Holds the element without copying or moving it and can be inserted into any HashMap
+     * of the same type. The handle keeps the node's slab storage alive, so it stays valid
+     * even if the map it came from is cleared or destroyed. An empty handle holds nothing.
+     */
+    class node_type {
+    public:
+        node_type() : node(nullptr) {}
+        node_type(node_type &&other) noexcept : node(other.node), lease(std::move(other.lease)) { other.node = nullptr; }
+        node_type& operator=(node_type &&other) noexcept {
+            if (this != &other) {
+                reset();
+                node = other.node;
+                lease = std::move(other.lease);
+                other.node = nullptr;
+            }
+            return *this;
+        }
+        node_type(const node_type &) = delete;
+        node_type& operator=(const node_type &) = delete;
+
+        /**
+         * @brief Destroys the element, if any. Its storage is reclaimed with the slab it lives in.
+         */
+        ~node_type() { reset(); }
+
+        /**
+         * @brief Checks whether the handle is empty.
+         */
+        bool empty() const { return node == nullptr; }
+        explicit operator bool() const { return node != nullptr; }
+
+        /**
+         * @brief Returns the key of the held element. The handle must not be empty.
+         */
+        const Key& key() const { return node->kv.first; }
+
+        /**
+         * @brief Returns the mapped value of the held element. The handle must not be empty.
+         */
+        Value& mapped() const { return node->kv.second; }
+
+    private:
+        Node* node;                                          ///< The extracted node, or nullptr.
+        typename NodePool<Node, Allocator>::Lease lease;    ///< Keeps the node's storage alive.
+
+        node_type(Node* n, typename NodePool<Node, Allocator>::Lease l) : node(n), lease(std::move(l)) {}
+
+        void reset() {
+            if (node)
+                std::destroy_at(node);
+            node = nullptr;
+            lease = {};
+        }
+
+        friend class HashMap;
+    };
+
+    /**
+     * @brief Result of inserting a node handle.
+     */
+    struct insert_return_type {
+        iterator position; ///< The element with the key of the node.
+        bool inserted;     ///< Whether the node was inserted.
+        node_type node;    ///< The node, handed back if its key already existed; otherwise empty.
+    };
+
     /**
      * @brief Constructs an empty HashMap with an initial bucket capacity and load factor threshold.
      *
-     * @param init_cap Initial number of buckets (default is 11).
+     * @param init_cap Initial number of buckets (default is 11), rounded to a count valid for the policy.
      * @param load     Maximum load factor before rehashing (default is 1.0).
+     * @param alloc    Allocator for node slabs.
      */
-    explicit HashMap(size_t init_cap = 11, double load = 1.0)
-        : capacity(init_cap), count(0), head(nullptr), tail(nullptr), max_load(load)
+    explicit HashMap(size_t init_cap = 11, double load = 1.0, const Allocator &alloc = Allocator())
+        : HashMap(init_cap, load, Hash(), alloc) {}
+
+    /**
+     * @brief Constructs an empty HashMap that uses the given hash function object.
+     *
+     * Needed for stateful hashers, e.g. a seeded_string_hash with an explicit seed.
+     *
+     * @param init_cap Initial number of buckets, rounded to a count valid for the policy.
+     * @param load     Maximum load factor before rehashing.
+     * @param hash     Hash function object.
+     * @param alloc    Allocator for node slabs.
+     */
+    HashMap(size_t init_cap, double load, const Hash &hash, const Allocator &alloc = Allocator())
+        : capacity(Policy::round_capacity(init_cap)), count(0), head(nullptr), tail(nullptr),
+          hashFunc(hash), max_load(load), pool(alloc),
+          old_buckets(nullptr), old_capacity(0), migrate_pos(0), incremental(false)
     {
         buckets = new Node*[capacity];
         for (size_t i = 0; i < capacity; ++i)
             buckets[i] = nullptr;
     }
 
+    /**
+     * @brief Constructs a HashMap from a range of key-value pairs.
+     *
+     * For forward ranges the bucket array is sized for the whole range up front, so the
+     * elements are linked in a single pass without any intermediate rehash. Duplicate keys
+     * behave like repeated insert(): the last value wins.
+     *
+     * @param first    Iterator to the first key-value pair.
+     * @param last     Iterator past the last key-value pair.
+     * @param init_cap Minimum initial number of buckets (default is 11).
+     * @param load     Maximum load factor before rehashing (default is 1.0).
+     * @param hash     Hash function object.
+     * @param alloc    Allocator for node slabs.
+     */
+    template<std::input_iterator InputIt>
+    HashMap(InputIt first, InputIt last, size_t init_cap = 11, double load = 1.0,
+            const Hash &hash = Hash(), const Allocator &alloc = Allocator())
+        : HashMap(init_cap, load, hash, alloc)
+    {
+        if constexpr (std::forward_iterator<InputIt>)
+            reserve(static_cast<size_t>(std::distance(first, last)));
+        for (; first != last; ++first) {
+            const auto &kv = *first;
+            insert_or_assign_node(kv.first, kv.second);
+        }
+    }
+
+    /**
+     * @brief Constructs a HashMap from an initializer list, sized once for all of its elements.
+     *
+     * @param init     The key-value pairs to insert.
+     * @param init_cap Minimum initial number of buckets (default is 11).
+     * @param load     Maximum load factor before rehashing (default is 1.0).
+     * @param hash     Hash function object.
+     * @param alloc    Allocator for node slabs.
+     */
+    HashMap(std::initializer_list<value_type> init, size_t init_cap = 11, double load = 1.0,
+            const Hash &hash = Hash(), const Allocator &alloc = Allocator())
+        : HashMap(init.begin(), init.end(), init_cap, load, hash, alloc) {}
+
     /**
      * @brief Copy constructor.
      *
@@ -327,14 +815,17 @@ public:
      */
     HashMap(const HashMap &other)
         : capacity(other.capacity), count(0), head(nullptr), tail(nullptr),
-          hashFunc(other.hashFunc), max_load(other.max_load)
+          hashFunc(other.hashFunc), max_load(other.max_load),
+          pool(std::allocator_traits<Allocator>::select_on_container_copy_construction(
+              other.pool.get_allocator())),
+          old_buckets(nullptr), old_capacity(0), migrate_pos(0), incremental(other.incremental)
     {
         buckets = new Node*[capacity];
         for (size_t i = 0; i < capacity; ++i)
             buckets[i] = nullptr;
         // Copy nodes from the other map preserving global order.
         for (Node* cur = other.head; cur; cur = cur->next) {
-            Node* newNode = new Node(cur->kv.first, cur->kv.second);
+            Node* newNode = create_node(cur->kv.first, cur->kv.second);
             // Append to global doubly linked list.
             newNode->prev = tail;
             newNode->next = nullptr;
@@ -344,7 +835,9 @@ public:
                 head = newNode;
             tail = newNode;
             // Insert into appropriate bucket.
-            size_t idx = hashFunc(newNode->kv.first) % capacity;
+            size_t hash = other.node_hash(cur);
+            newNode->hash.set(hash);
+            size_t idx = Policy::index(hash, capacity);
             newNode->bucket_next = buckets[idx];
             buckets[idx] = newNode;
             ++count;
@@ -361,10 +854,12 @@ public:
     HashMap(HashMap &&other) noexcept
         : buckets(other.buckets), capacity(other.capacity), count(other.count),
           head(other.head), tail(other.tail), hashFunc(std::move(other.hashFunc)),
-          max_load(other.max_load)
+          max_load(other.max_load), pool(std::move(other.pool)),
+          old_buckets(other.old_buckets), old_capacity(other.old_capacity),
+          migrate_pos(other.migrate_pos), incremental(other.incremental)
     {
-        other.buckets = nullptr;
-        other.capacity = 0;
+        other.buckets = other.old_buckets = nullptr;
+        other.capacity = other.old_capacity = other.migrate_pos = 0;
         other.count = 0;
         other.head = other.tail = nullptr;
     }
@@ -372,11 +867,12 @@ public:
     /**
      * @brief Destructor.
      *
-     * Clears all elements and frees allocated resources.
+     * Clears all elements and frees allocated resources, including every node slab.
      */
     ~HashMap(){
         clear();
         delete[] buckets;
+        delete[] old_buckets;
     }
 
     /**
@@ -407,6 +903,7 @@ public:
         if (this != &other) {
             clear();
             delete[] buckets;
+            delete[] old_buckets;
             buckets   = other.buckets;
             capacity  = other.capacity;
             count     = other.count;
@@ -414,8 +911,13 @@ public:
             tail      = other.tail;
             hashFunc  = std::move(other.hashFunc);
             max_load  = other.max_load;
-            other.buckets = nullptr;
-            other.capacity = 0;
+            pool      = std::move(other.pool);
+            old_buckets  = other.old_buckets;
+            old_capacity = other.old_capacity;
+            migrate_pos  = other.migrate_pos;
+            incremental  = other.incremental;
+            other.buckets = other.old_buckets = nullptr;
+            other.capacity = other.old_capacity = other.migrate_pos = 0;
             other.count = 0;
             other.head = other.tail = nullptr;
         }
@@ -435,24 +937,34 @@ public:
         std::swap(tail, other.tail);
         std::swap(hashFunc, other.hashFunc);
         std::swap(max_load, other.max_load);
+        pool.swap(other.pool);
+        std::swap(old_buckets, other.old_buckets);
+        std::swap(old_capacity, other.old_capacity);
+        std::swap(migrate_pos, other.migrate_pos);
+        std::swap(incremental, other.incremental);
     }
 
     /**
      * @brief Clears the HashMap.
      *
-     * Deletes all nodes and resets the container to an empty state.
+     * Destroys all nodes, returns the node slabs to the allocator in one go
+     * and resets the container to an empty state.
      */
     void clear() {
         Node* cur = head;
         while(cur) {
             Node* nxt = cur->next;
-            delete cur;
+            std::destroy_at(cur);
             cur = nxt;
         }
+        pool.release();
         head = tail = nullptr;
         count = 0;
         for (size_t i = 0; i < capacity; ++i)
             buckets[i] = nullptr;
+        delete[] old_buckets;
+        old_buckets = nullptr;
+        old_capacity = migrate_pos = 0;
     }
 
     /**
@@ -467,16 +979,116 @@ public:
      *
      * @return The ratio of the number of elements to the number of buckets.
      */
-    double load_factor() const { return capacity ? static_cast<double>(count) / capacity : 0; }
+    double load_factor() const { return capacity ? static_cast<double>(count) / static_cast<double>(capacity) : 0; }
+
+    /**
+     * @brief Returns the number of buckets.
+     */
+    size_t bucket_count() const { return capacity; }
+
+    /**
+     * @brief Returns the number of positions for for_each_in().
+     *
+     * Positions are the buckets followed by the buckets of an incremental rehash still in
+     * progress, so together they cover every element exactly once.
+     */
+    size_t scan_extent() const { return capacity + old_capacity; }
+
+    /**
+     * @brief Calls @p f on every element stored at positions [first, last).
+     *
+     * Disjoint position ranges hold disjoint elements, so a full scan can be split into
+     * independent ranges and processed concurrently (see mgc::parallel_for_each).
+     *
+     * @param first First position, at most scan_extent().
+     * @param last  Position past the last one, at most scan_extent().
+     * @param f     Callback invoked as f(const value_type&).
+     */
+    template<typename F>
+    void for_each_in(size_t first, size_t last, F &&f) const {
+        for (size_t i = first; i < last; ++i) {
+            // Migrated old buckets are null, so they contribute nothing.
+            const Node* cur = i < capacity ? buckets[i] : old_buckets[i - capacity];
+            for (; cur; cur = cur->bucket_next)
+                f(cur->kv);
+        }
+    }
 
     /**
      * @brief Manually rehashes the HashMap.
      *
-     * Rebuilds the table with the specified number of buckets.
+     * Rebuilds the table with the specified number of buckets, but never with fewer than
+     * the current elements need under max_load.
+     *
+     * @param new_cap The new bucket capacity, rounded to a count valid for the policy.
+     */
+    void rehash(size_t new_cap) { rehash_internal(std::max(new_cap, min_buckets(count))); }
+
+    /**
+     * @brief Makes room for at least @p n elements without further rehashing.
+     *
+     * Rehashes once if the current bucket count is too small for @p n elements under
+     * max_load; otherwise does nothing.
+     *
+     * @param n The number of elements to make room for.
+     */
+    void reserve(size_t n) {
+        size_t needed = min_buckets(n);
+        if (needed > capacity)
+            rehash_internal(needed);
+    }
+
+    /**
+     * @brief Releases memory no longer needed by the current elements.
+     *
+     * Shrinks the bucket array to the smallest size the elements need under max_load and
+     * moves the nodes into freshly allocated, densely packed slabs, so that the slabs left
+     * behind by mass erases are returned to the allocator. Iterators are invalidated.
+     */
+    void shrink_to_fit() {
+        HashMap tmp(min_buckets(count), max_load, hashFunc,
+                    std::allocator_traits<Allocator>::select_on_container_copy_construction(
+                        pool.get_allocator()));
+        tmp.incremental = incremental;
+        // All node storage is obtained up front, so nothing below allocates. Values are
+        // moved only when no step can throw (the const key is always copied); otherwise
+        // every element is copied, and a failed copy leaves this map untouched.
+        tmp.pool.reserve(count);
+        for (Node* cur = head; cur; cur = cur->next) {
+            // Keys are unique, so nodes are linked without a lookup.
+            size_t hash = node_hash(cur);
+            Node* n;
+            if constexpr (std::is_nothrow_copy_constructible_v<Key> && std::is_nothrow_move_constructible_v<Value>)
+                n = tmp.create_node(cur->kv.first, std::move(cur->kv.second));
+            else
+                n = tmp.create_node(std::as_const(cur->kv));
+            tmp.link_node(n, hash);
+        }
+        swap(tmp);
+    }
+
+    /**
+     * @brief Enables or disables incremental rehashing.
+     *
+     * When enabled, growth allocates the new bucket array and then migrates kRehashStep
+     * old buckets on each insert or erase, while lookups consult both arrays.
+     * Disabling the mode finishes any migration in progress.
+     *
+     * @param enable true to spread rehashing over subsequent mutations.
+     */
+    void set_incremental_rehash(bool enable) {
+        incremental = enable;
+        if (!enable)
+            while (old_buckets)
+                rehash_step();
+    }
+
+    /**
+     * @brief Checks whether an incremental rehash is currently in progress.
      *
-     * @param new_cap The new bucket capacity.
+     * @return true if an old bucket array is still being migrated.
      */
-    void rehash(size_t new_cap) { rehash_internal(new_cap); }
+    bool rehash_in_progress() const { return old_buckets != nullptr; }
 
     /**
      * @brief Inserts a key-value pair into the HashMap.
@@ -486,32 +1098,104 @@ public:
      * @param key   The key to insert.
      * @param value The value associated with the key.
      */
-    void insert(const Key &key, const Value &value) {
-        size_t idx = hashFunc(key) % capacity;
-        // Check if the key already exists in the bucket.
-        for (Node* cur = buckets[idx]; cur; cur = cur->bucket_next) {
-            if (cur->kv.first == key) {
-                cur->kv.second = value;
-                return;
-            }
+    void insert(const Key &key, const Value &value) { insert_or_assign_node(key, value); }
+
+    /**
+     * @brief Inserts a key-value pair into the HashMap, moving from the arguments.
+     *
+     * If the key already exists, its value is move-assigned.
+     *
+     * @param key   The key to insert.
+     * @param value The value associated with the key.
+     */
+    void insert(Key &&key, Value &&value) { insert_or_assign_node(std::move(key), std::move(value)); }
+
+    /**
+     * @brief Inserts an element constructed in place, unless its key already exists.
+     *
+     * The node is built first so that its key can be hashed; if the key is present the node is discarded.
+     *
+     * @param args Arguments forwarded to the key-value pair constructor.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        Node* n = create_node(std::forward<Args>(args)...);
+        size_t hash = hashFunc(n->kv.first);
+        if (Node** link = find_link(n->kv.first, hash)) {
+            destroy_node(n);
+            return {iterator(*link, this), false};
         }
-        // Create a new node.
-        Node* newNode = new Node(key, value);
-        // Insert into the bucket chain.
-        newNode->bucket_next = buckets[idx];
-        buckets[idx] = newNode;
-        // Append to the global doubly linked list.
-        newNode->prev = tail;
-        newNode->next = nullptr;
-        if (tail)
-            tail->next = newNode;
-        else
-            head = newNode;
-        tail = newNode;
-        ++count;
-        // Trigger rehashing if load factor exceeded.
-        if (load_factor() > max_load)
-            rehash_internal(capacity * 2 + 1);
+        link_node(n, hash);
+        return {iterator(n, this), true};
+    }
+
+    /**
+     * @brief Inserts an element with the value constructed from @p args, unless the key already exists.
+     *
+     * Nothing is constructed, copied or moved if the key is present.
+     *
+     * @param key  The key to insert.
+     * @param args Arguments forwarded to the Value constructor.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key &key, Args&&... args) {
+        auto [n, inserted] = try_emplace_node(key, std::forward<Args>(args)...);
+        return {iterator(n, this), inserted};
+    }
+
+    /**
+     * @brief Inserts an element with the value constructed from @p args, moving from the key.
+     *
+     * @param key  The key to insert; it is only moved from if the insertion takes place.
+     * @param args Arguments forwarded to the Value constructor.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(Key &&key, Args&&... args) {
+        auto [n, inserted] = try_emplace_node(std::move(key), std::forward<Args>(args)...);
+        return {iterator(n, this), inserted};
+    }
+
+    /**
+     * @brief Heterogeneous try_emplace: the key is only converted to Key if the insertion takes place.
+     *
+     * @param key  A value comparable with Key and convertible to it, e.g. a std::string_view for string keys.
+     * @param args Arguments forwarded to the Value constructor.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename K, typename... Args>
+        requires transparent_hash<Hash> && std::constructible_from<Key, K>
+    std::pair<iterator, bool> try_emplace(K &&key, Args&&... args) {
+        auto [n, inserted] = try_emplace_node(std::forward<K>(key), std::forward<Args>(args)...);
+        return {iterator(n, this), inserted};
+    }
+
+    /**
+     * @brief Inserts a new element or assigns to the mapped value of an existing one.
+     *
+     * @param key The key to insert or update.
+     * @param obj The value to store.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+        auto [n, inserted] = insert_or_assign_node(key, std::forward<M>(obj));
+        return {iterator(n, this), inserted};
+    }
+
+    /**
+     * @brief Inserts a new element or assigns to the mapped value of an existing one, moving from the key.
+     *
+     * @param key The key to insert or update.
+     * @param obj The value to store.
+     * @return An iterator to the element with the key, and true if the insertion took place.
+     */
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(Key &&key, M &&obj) {
+        auto [n, inserted] = insert_or_assign_node(std::move(key), std::forward<M>(obj));
+        return {iterator(n, this), inserted};
     }
 
     /**
@@ -523,76 +1207,172 @@ public:
      * @param key The key to access.
      * @return Reference to the associated value.
      */
-    Value& operator[](const Key &key) {
-        size_t idx = hashFunc(key) % capacity;
-        for (Node* cur = buckets[idx]; cur; cur = cur->bucket_next) {
-            if (cur->kv.first == key)
-                return cur->kv.second;
-        }
-        // Key not found; create a new node with default value.
-        Node* newNode = new Node(key, Value());
-        newNode->bucket_next = buckets[idx];
-        buckets[idx] = newNode;
-        newNode->prev = tail;
-        newNode->next = nullptr;
-        if (tail)
-            tail->next = newNode;
-        else
-            head = newNode;
-        tail = newNode;
-        ++count;
-        if (load_factor() > max_load)
-            rehash_internal(capacity * 2 + 1);
-        return newNode->kv.second;
-    }
+    Value& operator[](const Key &key) { return try_emplace_node(key).first->kv.second; }
+
+    /**
+     * @brief Access operator that moves from the key if a new element is inserted.
+     *
+     * @param key The key to access.
+     * @return Reference to the associated value.
+     */
+    Value& operator[](Key &&key) { return try_emplace_node(std::move(key)).first->kv.second; }
 
     /**
      * @brief Erases the element with the given key.
      *
      * @param key The key of the element to erase.
      */
-    void erase(const Key &key) {
-        size_t idx = hashFunc(key) % capacity;
-        Node* cur = buckets[idx];
-        Node* prevBucket = nullptr;
-        while (cur) {
-            if (cur->kv.first == key) {
-                // Remove from bucket chain.
-                if (prevBucket)
-                    prevBucket->bucket_next = cur->bucket_next;
-                else
-                    buckets[idx] = cur->bucket_next;
-                // Remove from global doubly linked list.
-                if (cur->prev)
-                    cur->prev->next = cur->next;
-                else
-                    head = cur->next;
-                if (cur->next)
-                    cur->next->prev = cur->prev;
-                else
-                    tail = cur->prev;
-                delete cur;
-                --count;
-                return;
-            }
-            prevBucket = cur;
-            cur = cur->bucket_next;
+    void erase(const Key &key) { erase_key(key); }
+
+    /**
+     * @brief Erases the element with an equivalent key (heterogeneous version).
+     *
+     * @param key A value comparable with Key, e.g. a std::string_view for string keys.
+     */
+    template<typename K> requires transparent_hash<Hash>
+    void erase(const K &key) { erase_key(key); }
+
+    /**
+     * @brief Erases the element an iterator points to.
+     *
+     * @param pos A valid, dereferenceable iterator into this map.
+     * @return An iterator to the element that followed it in iteration order.
+     */
+    iterator erase(iterator pos) {
+        Node* nxt = pos.node->next;
+        destroy_node(unlink(find_link(pos->first, node_hash(pos.node))));
+        return iterator(nxt, this);
+    }
+
+    /**
+     * @brief Moves an element to the end of the iteration order in O(1).
+     *
+     * Calling it on every access turns iteration order into recency order (least recently
+     * used first), which is what mgc::LruCache builds on. Iterators stay valid.
+     *
+     * @param pos A valid, dereferenceable iterator into this map.
+     */
+    void touch(iterator pos) {
+        Node* n = pos.node;
+        if (n == tail)
+            return;
+        // Unlink from the global list; n has a successor because it is not the tail.
+        if (n->prev)
+            n->prev->next = n->next;
+        else
+            head = n->next;
+        n->next->prev = n->prev;
+        // Append at the tail.
+        n->prev = tail;
+        n->next = nullptr;
+        tail->next = n;
+        tail = n;
+    }
+
+    /**
+     * @brief Unlinks the element with the given key and hands it over in a node handle.
+     *
+     * Nothing is copied, moved or deallocated.
+     *
+     * @param key The key of the element to extract.
+     * @return A handle owning the element, or an empty handle if the key is absent.
+     */
+    node_type extract(const Key &key) {
+        if (old_buckets)
+            rehash_step();
+        Node** link = find_link(key, hashFunc(key));
+        return link ? node_type(unlink(link), pool.lease()) : node_type();
+    }
+
+    /**
+     * @brief Unlinks the element an iterator points to and hands it over in a node handle.
+     *
+     * @param pos A valid, dereferenceable iterator into this map.
+     * @return A handle owning the element.
+     */
+    node_type extract(const_iterator pos) {
+        Node** link = find_link(pos->first, node_hash(pos.node));
+        return node_type(unlink(link), pool.lease());
+    }
+
+    /**
+     * @brief Unlinks the element an iterator points to and hands it over in a node handle.
+     *
+     * @param pos A valid, dereferenceable iterator into this map.
+     * @return A handle owning the element.
+     */
+    node_type extract(iterator pos) { return extract(const_iterator(pos.node, this)); }
+
+    /**
+     * @brief Links the node held by @p nh into this map, unless its key already exists.
+     *
+     * The element is neither copied nor moved; the map takes over the node and its storage.
+     * A node from another map makes this map's pool adopt the slab arenas of that map, which
+     * allocates the first time and whenever an arena is new to this map. Reinserting a node
+     * into the map it came from never allocates.
+     *
+     * @param nh A node handle, e.g. from extract() on this or another map of the same type.
+     * @return The position of the element with the key, whether the node was inserted, and
+     *         the node handed back if it was not.
+     * @throws std::bad_alloc If adopting the arenas fails, in which case @p nh still owns the
+     *         node and the map is unchanged; or, as for any insert, if growing the bucket
+     *         array afterwards fails, in which case the node is already in the map.
+     */
+    insert_return_type insert(node_type &&nh) {
+        if (nh.empty())
+            return {end(), false, node_type()};
+        size_t hash = foreign_hash(nh.node);
+        if (Node** link = find_link(nh.node->kv.first, hash))
+            return {iterator(*link, this), false, std::move(nh)};
+        pool.adopt(nh.lease);
+        Node* n = nh.node;
+        nh.node = nullptr;
+        nh.lease = {};
+        link_node(n, hash);
+        return {iterator(n, this), true, node_type()};
+    }
+
+    /**
+     * @brief Moves every element whose key is not present here from @p other into this map.
+     *
+     * Nodes are relinked, not copied: the cost is a few pointer updates per element, plus
+     * rehashing keys only if Hash is stateful or hashes are not cached. Elements whose key
+     * already exists here stay in @p other. Before any node moves, this map adopts the slab
+     * arenas of @p other (see insert(node_type&&)) and grows its bucket array for both maps'
+     * elements; both steps may allocate.
+     *
+     * @param other The map to take elements from.
+     * @throws std::bad_alloc If adopting the arenas or growing the bucket array fails; no
+     *         element has moved then.
+     */
+    void merge(HashMap &other) {
+        if (&other == this || other.count == 0)
+            return;
+        pool.adopt(other.pool.lease());
+        reserve(count + other.count);
+        for (Node* cur = other.head; cur; ) {
+            Node* nxt = cur->next;
+            size_t hash = foreign_hash(cur);
+            if (!find_link(cur->kv.first, hash))
+                link_node(other.unlink(other.find_link(cur->kv.first, other.node_hash(cur))), hash);
+            cur = nxt;
         }
     }
 
+    /**
+     * @brief Moves every element whose key is not present here from @p other into this map.
+     *
+     * @param other The map to take elements from.
+     */
+    void merge(HashMap &&other) { merge(other); }
+
     /**
      * @brief Finds an element by key.
      *
      * @param key The key to search for.
      * @return An iterator to the element if found, or end() if not found.
      */
-    iterator find(const Key &key) {
-        size_t idx = hashFunc(key) % capacity;
-        for (Node* cur = buckets[idx]; cur; cur = cur->bucket_next)
-            if (cur->kv.first == key)
-                return iterator(cur, this);
-        return end();
-    }
+    iterator find(const Key &key) { return iterator(find_node(key), this); }
 
     /**
      * @brief Finds an element by key (const version).
@@ -600,12 +1380,79 @@ public:
      * @param key The key to search for.
      * @return A const_iterator to the element if found, or end() if not found.
      */
-    const_iterator find(const Key &key) const {
-        size_t idx = hashFunc(key) % capacity;
-        for (Node* cur = buckets[idx]; cur; cur = cur->bucket_next)
-            if (cur->kv.first == key)
-                return const_iterator(cur, this);
-        return end();
+    const_iterator find(const Key &key) const { return const_iterator(find_node(key), this); }
+
+    /**
+     * @brief Finds an element with an equivalent key (heterogeneous version).
+     *
+     * @param key A value comparable with Key, e.g. a std::string_view for string keys.
+     * @return An iterator to the element if found, or end() if not found.
+     */
+    template<typename K> requires transparent_hash<Hash>
+    iterator find(const K &key) { return iterator(find_node(key), this); }
+
+    /**
+     * @brief Finds an element with an equivalent key (heterogeneous const version).
+     *
+     * @param key A value comparable with Key, e.g. a std::string_view for string keys.
+     * @return A const_iterator to the element if found, or end() if not found.
+     */
+    template<typename K> requires transparent_hash<Hash>
+    const_iterator find(const K &key) const { return const_iterator(find_node(key), this); }
+
+    /**
+     * @brief Checks whether an element with the given key exists.
+     *
+     * @param key The key to search for.
+     * @return true if the key is present.
+     */
+    bool contains(const Key &key) const { return find_node(key) != nullptr; }
+
+    /**
+     * @brief Checks whether an element with an equivalent key exists (heterogeneous version).
+     *
+     * @param key A value comparable with Key, e.g. a std::string_view for string keys.
+     * @return true if the key is present.
+     */
+    template<typename K> requires transparent_hash<Hash>
+    bool contains(const K &key) const { return find_node(key) != nullptr; }
+
+    /**
+     * @brief Looks up a batch of keys, overlapping their memory latency.
+     *
+     * Equivalent to calling find() for every key in order, but the keys are hashed and
+     * their buckets prefetched in blocks before any chain is walked, so a large batch pays
+     * for roughly one cache miss per block instead of one per key. @p f must not insert
+     * into or erase from the map.
+     *
+     * @param keys Random-access range of keys (Key, or compatible types if Hash is transparent).
+     * @param f    Callback invoked as f(index, iterator), where iterator is end() for a missing key.
+     */
+    template<std::ranges::random_access_range R, typename F>
+        requires std::ranges::sized_range<R>
+              && (transparent_hash<Hash> || std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<R>>, Key>)
+    void visit_many(R &&keys, F &&f) { visit_many_impl(*this, keys, f); }
+
+    /**
+     * @brief Looks up a batch of keys, overlapping their memory latency (const version).
+     *
+     * @param keys Random-access range of keys (Key, or compatible types if Hash is transparent).
+     * @param f    Callback invoked as f(index, const_iterator), where the iterator is end() for a missing key.
+     */
+    template<std::ranges::random_access_range R, typename F>
+        requires std::ranges::sized_range<R>
+              && (transparent_hash<Hash> || std::same_as<std::remove_cvref_t<std::ranges::range_reference_t<R>>, Key>)
+    void visit_many(R &&keys, F &&f) const { visit_many_impl(*this, keys, f); }
+
+    /**
+     * @brief Looks up a batch of keys and writes one iterator per key to @p out.
+     *
+     * @param keys Random-access range of keys (Key, or compatible types if Hash is transparent).
+     * @param out  Output iterator receiving an iterator per key, end() for a missing key.
+     */
+    template<std::ranges::random_access_range R, typename OutIt>
+    void find_many(R &&keys, OutIt out) {
+        visit_many(keys, [&out](size_t, iterator it) { *out++ = it; });
     }
 
     /**
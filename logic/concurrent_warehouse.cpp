@@ -0,0 +1,73 @@
+#include "concurrent_warehouse.hpp"
+#include <stdexcept>
+
+namespace mgw {
+
+void concurrent_warehouse::register_product(std::string_view cipher, const product_components &pr){
+    auto restock = [&pr](const auto &kv){ kv.second.stock.add(kv.second.item->stock_units(pr.quantity)); };
+    // Restocking only reads the table; the stock counter itself is atomic.
+    if(product_table.cvisit(cipher, restock))
+        return;
+    std::shared_ptr<product> created = make_product(pr);
+    const size_t initial = created->get_quantity();
+    product_table.try_emplace_or_visit(cipher, restock, entry{initial, std::move(created)});
+}
+
+size_t concurrent_warehouse::sell_product(std::string_view cipher, size_t num){
+    size_t price = 0;
+    bool in_stock = true;
+    bool found = product_table.cvisit(cipher, [&](const auto &kv){
+        const product &p = *kv.second.item;
+        in_stock = kv.second.stock.take(p.stock_units(num));
+        if(in_stock)
+            price = p.price(num);
+    });
+    if(!found)
+        throw std::invalid_argument("Error: No such product");
+    if(!in_stock)
+        throw std::invalid_argument("Error: Insufficient quantity");
+    return price;
+}
+
+bool concurrent_warehouse::remove_product(std::string_view cipher){
+    return product_table.erase(cipher);
+}
+
+size_t concurrent_warehouse::get_quantity(std::string_view cipher) const{
+    size_t quantity = 0;
+    if(!product_table.cvisit(cipher, [&](const auto &kv){ quantity = kv.second.stock.load(); }))
+        throw std::invalid_argument("Error: No such product");
+    return quantity;
+}
+
+string concurrent_warehouse::get_report()const{
+    string result;
+    product_table.for_each([&result](const auto &kv){
+        kv.second.item->append_Info(result, kv.second.stock.load());
+        result += '\n';
+    });
+    return result;
+}
+
+void concurrent_warehouse::write_report(std::ostream &os)const{
+    string line;
+    product_table.for_each([&](const auto &kv){
+        line.clear();
+        kv.second.item->append_Info(line, kv.second.stock.load());
+        line += '\n';
+        os.write(line.data(), static_cast<std::streamsize>(line.size()));
+    });
+}
+
+string concurrent_warehouse::missing_products()const{
+    string result;
+    product_table.for_each([&result](const auto &kv){
+        if(kv.second.stock.load() == 0){
+            result += kv.second.item->get_name();
+            result += '\n';
+        }
+    });
+    return result;
+}
+
+}
@@ -0,0 +1,129 @@
+#ifndef CONCURRENT_WAREHOUSE_HPP_
+#define CONCURRENT_WAREHOUSE_HPP_
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "product_key.hpp"
+#include "stock_counter.hpp"
+#include "warehouse.hpp"
+#include "../container/concurrent_hash_map.hpp"
+#include "../container/flat_hash_map.hpp"
+
+namespace mgw {
+
+/**
+ * @class concurrent_warehouse
+ * @brief A warehouse that can be used from several threads at once.
+ *
+ * Products live in a sharded concurrent table whose shards are open-addressing
+ * FlatHashMaps, so a lookup under the shard lock is one probe into a flat array rather
+ * than a walk along a node chain. Sales and restocks of existing products
+ * only take their shard in shared mode: each entry keeps its stock in an atomic counter
+ * (see stock_counter) next to the product, so concurrent sales of different products
+ * never wait for each other, and concurrent sales of the same product never oversell.
+ * The quantity stored in the product itself is only its initial stock and is not kept
+ * up to date. Registering a new cipher or removing one locks a single shard exclusively.
+ *
+ * Reports and the list of missing products are built one shard at a time, so under
+ * concurrent sales they are a snapshot of each shard, not of the whole warehouse.
+ */
+class concurrent_warehouse {
+    /**
+     * @brief A product together with its stock.
+     */
+    struct entry {
+        mutable stock_counter stock;   ///< Quantity in stock; changed under a shared shard lock.
+        std::shared_ptr<product> item; ///< The product, read-only once registered.
+    };
+
+    mgc::ConcurrentHashMap<cipher_key, entry, mgc::fixed_key_hash, mgc::FlatHashMap> product_table; ///< Storage for products, mapped by their cipher.
+
+public:
+    /**
+     * @brief Default constructor.
+     *
+     * Initializes an empty warehouse with the default number of shards.
+     */
+    concurrent_warehouse() = default;
+
+    /**
+     * @brief Constructs an empty warehouse with a chosen number of shards.
+     *
+     * @param shards_hint Requested number of shards, rounded up to a power of two.
+     */
+    explicit concurrent_warehouse(size_t shards_hint) : product_table(shards_hint) {}
+
+    /**
+     * @brief Registers a new product, or adds its quantity to the existing one.
+     *
+     * A new product is created before any lock is taken; if another thread registers the
+     * same cipher first, the quantity is added to that product instead.
+     *
+     * @param cipher Unique identifier for the product.
+     * @param pr Struct containing product details.
+     * @throws std::invalid_argument If the product type is incorrect.
+     * @throws std::length_error If the cipher is longer than cipher_key::max_size.
+     */
+    void register_product(std::string_view cipher, const product_components &pr);
+
+    /**
+     * @brief Processes the sale of a product.
+     *
+     * @param cipher Unique identifier of the product to be sold.
+     * @param num The number of units (or wholesale batches) to sell.
+     * @return The total sale price.
+     * @throws std::invalid_argument If the product does not exist or there is insufficient stock.
+     */
+    size_t sell_product(std::string_view cipher, size_t num);
+
+    /**
+     * @brief Removes a product from the warehouse.
+     *
+     * @param cipher Unique identifier of the product to remove.
+     * @return true if the product existed.
+     */
+    bool remove_product(std::string_view cipher);
+
+    /**
+     * @brief Returns the quantity in stock of a product.
+     *
+     * @param cipher Unique identifier of the product.
+     * @throws std::invalid_argument If the product does not exist.
+     */
+    size_t get_quantity(std::string_view cipher) const;
+
+    /**
+     * @brief Returns the number of registered products.
+     */
+    size_t size() const { return product_table.size(); }
+
+    /**
+     * @brief Generates a report containing all products in the warehouse.
+     *
+     * Products are listed shard by shard in table order, which follows the hashes of the
+     * ciphers and so changes from run to run; sort the lines to compare reports.
+     *
+     * @return A formatted string listing all products and their details.
+     */
+    string get_report() const;
+
+    /**
+     * @brief Writes the report to a stream, one product at a time.
+     *
+     * @param os The stream to write to. Each shard stays locked in shared mode while its lines are written.
+     */
+    void write_report(std::ostream &os) const;
+
+    /**
+     * @brief Lists all products that are out of stock.
+     *
+     * @return A formatted string containing the names of products with zero quantity.
+     */
+    string missing_products() const;
+};
+
+} // namespace mgw
+
+#endif // CONCURRENT_WAREHOUSE_HPP_
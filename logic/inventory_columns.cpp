@@ -0,0 +1,176 @@
+#include "inventory_columns.hpp"
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace mgw {
+
+namespace {
+
+#if defined(__AVX2__)
+/// Four 64-bit lanes.
+struct lanes {
+    using reg = __m256i;
+    static constexpr size_t width = 4;
+    static reg load(const uint64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const reg*>(p)); }
+    static void store(uint64_t* p, reg v) { _mm256_storeu_si256(reinterpret_cast<reg*>(p), v); }
+    static reg zero() { return _mm256_setzero_si256(); }
+    static reg set1(uint64_t v) { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+    static reg add(reg a, reg b) { return _mm256_add_epi64(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_epi64(a, b); }
+    static reg bit_or(reg a, reg b) { return _mm256_or_si256(a, b); }
+    static reg bit_xor(reg a, reg b) { return _mm256_xor_si256(a, b); }
+    static reg andnot(reg a, reg b) { return _mm256_andnot_si256(a, b); }
+    static reg mul32(reg a, reg b) { return _mm256_mul_epu32(a, b); }
+    template<int N> static reg shl(reg a) { return _mm256_slli_epi64(a, N); }
+    template<int N> static reg shr(reg a) { return _mm256_srli_epi64(a, N); }
+};
+#elif defined(__SSE2__)
+/// Two 64-bit lanes.
+struct lanes {
+    using reg = __m128i;
+    static constexpr size_t width = 2;
+    static reg load(const uint64_t* p) { return _mm_loadu_si128(reinterpret_cast<const reg*>(p)); }
+    static void store(uint64_t* p, reg v) { _mm_storeu_si128(reinterpret_cast<reg*>(p), v); }
+    static reg zero() { return _mm_setzero_si128(); }
+    static reg set1(uint64_t v) { return _mm_set1_epi64x(static_cast<long long>(v)); }
+    static reg add(reg a, reg b) { return _mm_add_epi64(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_epi64(a, b); }
+    static reg bit_or(reg a, reg b) { return _mm_or_si128(a, b); }
+    static reg bit_xor(reg a, reg b) { return _mm_xor_si128(a, b); }
+    static reg andnot(reg a, reg b) { return _mm_andnot_si128(a, b); }
+    static reg mul32(reg a, reg b) { return _mm_mul_epu32(a, b); }
+    template<int N> static reg shl(reg a) { return _mm_slli_epi64(a, N); }
+    template<int N> static reg shr(reg a) { return _mm_srli_epi64(a, N); }
+};
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+/// Adds up the lanes of a register.
+uint64_t horizontal_sum(lanes::reg v) {
+    uint64_t parts[lanes::width];
+    lanes::store(parts, v);
+    uint64_t sum = 0;
+    for (uint64_t p : parts)
+        sum += p;
+    return sum;
+}
+
+/// Low 64 bits of a * b per lane, from three 32 x 32 -> 64 multiplies.
+lanes::reg mul64(lanes::reg a, lanes::reg b) {
+    lanes::reg lo = lanes::mul32(a, b);
+    lanes::reg cross = lanes::add(lanes::mul32(lanes::shr<32>(a), b), lanes::mul32(a, lanes::shr<32>(b)));
+    return lanes::add(lo, lanes::shl<32>(cross));
+}
+
+/// 1 in each lane where a < b (unsigned), from the borrow of a - b.
+lanes::reg less_than(lanes::reg a, lanes::reg b) {
+    lanes::reg diff = lanes::sub(a, b);
+    lanes::reg borrow = lanes::bit_or(lanes::andnot(a, b), lanes::andnot(lanes::bit_xor(a, b), diff));
+    return lanes::shr<63>(borrow);
+}
+#endif
+
+uint64_t sum(std::span<const uint64_t> xs) {
+    size_t i = 0;
+    uint64_t total = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    lanes::reg acc = lanes::zero();
+    for (; i + lanes::width <= xs.size(); i += lanes::width)
+        acc = lanes::add(acc, lanes::load(xs.data() + i));
+    total = horizontal_sum(acc);
+#endif
+    for (; i < xs.size(); ++i)
+        total += xs[i];
+    return total;
+}
+
+uint64_t dot(std::span<const uint64_t> xs, std::span<const uint64_t> ys) {
+    size_t i = 0;
+    uint64_t total = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    lanes::reg acc = lanes::zero();
+    for (; i + lanes::width <= xs.size(); i += lanes::width)
+        acc = lanes::add(acc, mul64(lanes::load(xs.data() + i), lanes::load(ys.data() + i)));
+    total = horizontal_sum(acc);
+#endif
+    for (; i < xs.size(); ++i)
+        total += xs[i] * ys[i];
+    return total;
+}
+
+size_t count_less(std::span<const uint64_t> xs, uint64_t threshold) {
+    size_t i = 0;
+    uint64_t total = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    lanes::reg acc = lanes::zero();
+    const lanes::reg t = lanes::set1(threshold);
+    for (; i + lanes::width <= xs.size(); i += lanes::width)
+        acc = lanes::add(acc, less_than(lanes::load(xs.data() + i), t));
+    total = horizontal_sum(acc);
+#endif
+    for (; i < xs.size(); ++i)
+        total += xs[i] < threshold;
+    return static_cast<size_t>(total);
+}
+
+} // namespace
+
+size_t inventory_columns::insert(const cipher_key &cipher, product_kind kind, uint64_t q, uint64_t c, uint64_t extra) {
+    // Grow every column before writing any, so a failed allocation leaves the rows aligned.
+    if (size() == row_capacity())
+        reserve(std::max<size_t>(16, 2 * size()));
+    ciphers.push_back(cipher);
+    kinds.push_back(kind);
+    quantity.push_back(q);
+    cost.push_back(c);
+    allowance.push_back(kind == product_kind::retail ? extra : 0);
+    wholesale_size.push_back(kind == product_kind::wholesale ? extra : 0);
+    return size() - 1;
+}
+
+void inventory_columns::erase(size_t row) {
+    ciphers[row] = ciphers.back();
+    ciphers.pop_back();
+    kinds[row] = kinds.back();
+    kinds.pop_back();
+    for (std::vector<uint64_t>* column : {&quantity, &cost, &allowance, &wholesale_size}) {
+        (*column)[row] = column->back();
+        column->pop_back();
+    }
+}
+
+size_t inventory_columns::row_capacity() const {
+    size_t cap = std::min(ciphers.capacity(), kinds.capacity());
+    for (const std::vector<uint64_t>* column : {&quantity, &cost, &allowance, &wholesale_size})
+        cap = std::min(cap, column->capacity());
+    return cap;
+}
+
+void inventory_columns::clear() {
+    ciphers.clear();
+    kinds.clear();
+    quantity.clear();
+    cost.clear();
+    allowance.clear();
+    wholesale_size.clear();
+}
+
+void inventory_columns::reserve(size_t n) {
+    ciphers.reserve(n);
+    kinds.reserve(n);
+    for (std::vector<uint64_t>* column : {&quantity, &cost, &allowance, &wholesale_size})
+        column->reserve(n);
+}
+
+uint64_t inventory_columns::total_stock() const { return sum(quantity); }
+
+uint64_t inventory_columns::inventory_value() const { return dot(quantity, cost); }
+
+size_t inventory_columns::count_below(uint64_t threshold) const { return count_less(quantity, threshold); }
+
+} // namespace mgw
@@ -0,0 +1,117 @@
+#ifndef INVENTORY_COLUMNS_HPP_
+#define INVENTORY_COLUMNS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+#include "product_key.hpp"
+
+namespace mgw {
+
+/**
+ * @class inventory_columns
+ * @brief Columnar copy of the numeric product fields, for catalog-wide aggregates.
+ *
+ * Quantity, cost, allowance and wholesale size are kept in four separate contiguous
+ * arrays with one row per product, so a scan reads only the columns it needs and never
+ * touches names or product objects. The aggregate kernels process four (AVX2) or two
+ * (SSE2) rows per instruction.
+ *
+ * Rows are appended in insertion order and carry no index of their own: the owner keeps
+ * each product's row next to its own record (see warehouse). When a row is erased, the
+ * last row moves into its place, so the owner must repoint that product. Allowance is
+ * zero for wholesale rows and wholesale size is zero for retail rows. Sums wrap around
+ * modulo 2^64.
+ */
+class inventory_columns {
+    std::vector<cipher_key> ciphers;      ///< Product cipher, per row.
+    std::vector<product_kind> kinds;      ///< Product kind, per row.
+    std::vector<uint64_t> quantity;       ///< Quantity in stock, per row.
+    std::vector<uint64_t> cost;           ///< Cost per unit, per row.
+    std::vector<uint64_t> allowance;      ///< Retail markup percentage, per row.
+    std::vector<uint64_t> wholesale_size; ///< Units per wholesale batch, per row.
+
+    /// Number of rows every column can hold without reallocating.
+    size_t row_capacity() const;
+
+public:
+    /**
+     * @brief Appends a row for a product.
+     *
+     * @param cipher  The product cipher.
+     * @param kind    The product kind.
+     * @param q       Quantity in stock.
+     * @param c       Cost per unit.
+     * @param extra   Allowance for retail products, wholesale size for wholesale products.
+     * @return The row of the product: the previous size().
+     */
+    size_t insert(const cipher_key &cipher, product_kind kind, uint64_t q, uint64_t c, uint64_t extra);
+
+    /**
+     * @brief Updates the quantity of the product in a row.
+     *
+     * Owners keep the row next to their own record of the product, so updating the
+     * column needs no lookup.
+     */
+    void set_quantity(size_t row, uint64_t q) { quantity[row] = q; }
+
+    /**
+     * @brief Removes a row, moving the last row into its place.
+     *
+     * @param row The row to remove, below size().
+     */
+    void erase(size_t row);
+
+    /**
+     * @brief Removes every row.
+     */
+    void clear();
+
+    /**
+     * @brief Makes room for @p n rows, so that inserting up to @p n rows does not allocate.
+     */
+    void reserve(size_t n);
+
+    /**
+     * @brief Returns the number of rows.
+     */
+    size_t size() const { return quantity.size(); }
+
+    /**
+     * @brief Returns the cipher of a row.
+     */
+    std::string_view cipher(size_t row) const { return ciphers[row].view(); }
+
+    /**
+     * @brief Returns the product kind of a row.
+     */
+    product_kind kind(size_t row) const { return kinds[row]; }
+
+    std::span<const uint64_t> quantities() const { return quantity; }           ///< Quantity column.
+    std::span<const uint64_t> costs() const { return cost; }                    ///< Cost column.
+    std::span<const uint64_t> allowances() const { return allowance; }          ///< Allowance column.
+    std::span<const uint64_t> wholesale_sizes() const { return wholesale_size; } ///< Wholesale size column.
+
+    /**
+     * @brief Returns the total quantity in stock over all products.
+     */
+    uint64_t total_stock() const;
+
+    /**
+     * @brief Returns the value of the stock at cost: the sum of quantity * cost.
+     */
+    uint64_t inventory_value() const;
+
+    /**
+     * @brief Counts the products whose quantity is below a threshold.
+     *
+     * @param threshold Products with quantity < threshold are counted.
+     */
+    size_t count_below(uint64_t threshold) const;
+};
+
+} // namespace mgw
+
+#endif // INVENTORY_COLUMNS_HPP_
@@ -0,0 +1,22 @@
+#ifndef PRODUCT_KEY_HPP_
+#define PRODUCT_KEY_HPP_
+
+#include "../container/fixed_key.hpp"
+
+namespace mgw {
+
+/// Product cipher stored inline in the product table; holds up to 31 characters.
+using cipher_key = mgc::fixed_key<32>;
+
+/**
+ * @enum product_kind
+ * @brief The concrete type of a product.
+ */
+enum class product_kind : unsigned char {
+    retail,   ///< retail_product
+    wholesale ///< wholesale_product
+};
+
+} // namespace mgw
+
+#endif // PRODUCT_KEY_HPP_
@@ -0,0 +1,65 @@
+#ifndef STOCK_COUNTER_HPP_
+#define STOCK_COUNTER_HPP_
+
+#include <atomic>
+#include <cstddef>
+
+namespace mgw {
+
+/**
+ * @class stock_counter
+ * @brief A stock quantity that can be changed from several threads and never goes below zero.
+ *
+ * Taking stock is a compare-and-swap loop, so concurrent sales of the same product never
+ * oversell. The counter fills a whole cache line, so a counter hammered by sales does not
+ * false-share with its neighbours or with the rest of its table entry. Copying a counter
+ * copies its current value.
+ *
+ * The counter does not publish any other data, so relaxed ordering is enough.
+ */
+class alignas(64) stock_counter {
+    std::atomic<size_t> value; ///< Current quantity.
+
+public:
+    /**
+     * @brief Constructs a counter.
+     * @param v Initial quantity (default is zero).
+     */
+    stock_counter(size_t v = 0) noexcept : value(v) {}
+
+    stock_counter(const stock_counter &other) noexcept : value(other.load()) {}
+
+    stock_counter& operator=(const stock_counter &other) noexcept {
+        value.store(other.load(), std::memory_order_relaxed);
+        return *this;
+    }
+
+    /**
+     * @brief Returns the current quantity.
+     */
+    size_t load() const noexcept { return value.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Adds stock.
+     * @param n The quantity to add.
+     */
+    void add(size_t n) noexcept { value.fetch_add(n, std::memory_order_relaxed); }
+
+    /**
+     * @brief Removes stock if enough is available.
+     * @param n The quantity to remove.
+     * @return false, leaving the counter unchanged, if less than @p n is in stock.
+     */
+    bool take(size_t n) noexcept {
+        size_t cur = value.load(std::memory_order_relaxed);
+        do {
+            if (cur < n)
+                return false;
+        } while (!value.compare_exchange_weak(cur, cur - n, std::memory_order_relaxed));
+        return true;
+    }
+};
+
+} // namespace mgw
+
+#endif // STOCK_COUNTER_HPP_
@@ -0,0 +1,95 @@
+#include "variant_warehouse.hpp"
+#include <ranges>
+#include <stdexcept>
+
+namespace mgw {
+
+void variant_warehouse::register_product(std::string_view cipher, const product_components &pr){
+    // One probe: try_emplace constructs the product in its slot only for a new cipher.
+    const size_t row = listing.size();
+    auto emplace = [&](auto type){
+        return product_table.try_emplace(cipher, row, type, pr.quantity, pr.cost, pr.name, pr.firm, pr.country, pr.num);
+    };
+    auto [slot, inserted] = parse_product_kind(pr.type) == product_kind::retail
+        ? emplace(std::in_place_type<retail_product>)
+        : emplace(std::in_place_type<wholesale_product>);
+    if(!inserted){
+        std::visit([&pr](auto &p){ p.add_to_storage(pr.quantity); }, slot->second.item);
+        return;
+    }
+    try{
+        listing.push_back(slot->first);
+    }
+    catch(...){
+        // Do not leave a product behind that the reports would not list.
+        product_table.erase(cipher);
+        throw;
+    }
+}
+
+size_t variant_warehouse::sell_product(std::string_view cipher, size_t num){
+    auto pos = product_table.find(cipher);
+    if(pos == product_table.end())
+        throw std::invalid_argument("Error: No such product");
+    return std::visit([num](auto &p){ return p.sell(num); }, pos->second.item);
+}
+
+size_t variant_warehouse::sell_products(std::span<const order> orders){
+    size_t total = 0;
+    product_table.visit_many(orders | std::views::transform(&order::cipher), [&](size_t i, auto pos) {
+        if (pos == product_table.end())
+            throw std::invalid_argument("Error: No such product");
+        total += std::visit([num = orders[i].num](auto &p){ return p.sell(num); }, pos->second.item);
+    });
+    return total;
+}
+
+bool variant_warehouse::remove_product(std::string_view cipher){
+    auto pos = product_table.find(cipher);
+    if(pos == product_table.end())
+        return false;
+    const size_t row = pos->second.row;
+    product_table.erase(cipher);
+    listing[row] = listing.back();
+    listing.pop_back();
+    // The last cipher has moved into the freed position; point its product at it.
+    if(row < listing.size())
+        product_table.find(listing[row])->second.row = row;
+    return true;
+}
+
+string variant_warehouse::get_report()const{
+    string result;
+    write_report(result);
+    return result;
+}
+
+void variant_warehouse::write_report(string &buffer)const{
+    for_each_product([&buffer](std::string_view, const auto &p){
+        p.append_Info(buffer);
+        buffer += '\n';
+    });
+}
+
+void variant_warehouse::write_report(std::ostream &os)const{
+    string line;
+    for_each_product([&](std::string_view, const auto &p){
+        line.clear();
+        p.append_Info(line);
+        line += '\n';
+        os.write(line.data(), static_cast<std::streamsize>(line.size()));
+    });
+}
+
+string variant_warehouse::missing_products()const{
+    string result;
+    for_each_product([&result](std::string_view, const auto &p){
+        if(p.get_quantity() == 0){
+            result += p.get_name();
+            result += '\n';
+        }
+    });
+    return result;
+}
+
+}
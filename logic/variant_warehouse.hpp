@@ -0,0 +1,162 @@
+#ifndef VARIANT_WAREHOUSE_HPP_
+#define VARIANT_WAREHOUSE_HPP_
+
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "product_key.hpp"
+#include "warehouse.hpp"
+#include "../products/retail_product.hpp"
+#include "../products/wholesale_product.hpp"
+
+namespace mgw {
+
+/**
+ * @brief A product stored by value. The alternative index is its product_kind.
+ */
+using product_variant = std::variant<retail_product, wholesale_product>;
+
+static_assert(std::is_same_v<std::variant_alternative_t<static_cast<size_t>(product_kind::retail), product_variant>, retail_product> &&
+              std::is_same_v<std::variant_alternative_t<static_cast<size_t>(product_kind::wholesale), product_variant>, wholesale_product>,
+              "product_variant alternatives must follow product_kind");
+
+/**
+ * @brief Returns the kind of a stored product.
+ */
+inline product_kind kind_of(const product_variant &p) { return static_cast<product_kind>(p.index()); }
+
+/**
+ * @class variant_warehouse
+ * @brief A warehouse that stores products by value instead of behind shared pointers.
+ *
+ * Same interface as warehouse, but every product lives inside its table slot as a
+ * product_variant. There is no per-product allocation and no reference count. Every
+ * operation dispatches on the variant index, and because retail_product and
+ * wholesale_product are final, the calls are direct and can be inlined. Bulk operations
+ * such as reports and for_each_product() run without any virtual calls.
+ *
+ * Products move when the table grows, so no references to them are handed out.
+ */
+class variant_warehouse {
+    /**
+     * @brief A product and its position in the listing.
+     */
+    struct product_slot {
+        product_variant item; ///< The product.
+        size_t row;           ///< Position of the product's cipher in listing.
+
+        template<typename... Args>
+        explicit product_slot(size_t r, Args&&... args) : item(std::forward<Args>(args)...), row(r) {}
+    };
+
+    mgc::FlatHashMap<cipher_key, product_slot, mgc::fixed_key_hash> product_table; ///< Products, stored inline and mapped by their cipher.
+    std::vector<cipher_key> listing; ///< Cipher of every product, in the order of reports.
+
+public:
+    /**
+     * @brief Default constructor.
+     *
+     * Initializes an empty warehouse.
+     */
+    variant_warehouse() = default;
+
+    /**
+     * @brief Registers a new product, or adds its quantity to the existing one.
+     *
+     * A single table probe either constructs the product in place or finds the existing
+     * one, so the type is checked before the lookup, also when restocking. An existing
+     * product keeps its own type.
+     *
+     * @param cipher Unique identifier for the product.
+     * @param pr Struct containing product details.
+     * @throws std::invalid_argument If the product type is incorrect.
+     * @throws std::length_error If the cipher is longer than cipher_key::max_size.
+     */
+    void register_product(std::string_view cipher, const product_components &pr);
+
+    /**
+     * @brief Processes the sale of a product.
+     *
+     * @param cipher Unique identifier of the product to be sold.
+     * @param num The number of units (or wholesale batches) to sell.
+     * @return The total sale price.
+     * @throws std::invalid_argument If the product does not exist or there is insufficient stock.
+     */
+    size_t sell_product(std::string_view cipher, size_t num);
+
+    /**
+     * @brief Processes a batch of sales with prefetched lookups.
+     *
+     * If an order fails, the orders before it stay sold.
+     *
+     * @param orders The orders to process, in order.
+     * @return The total sale price of all orders.
+     * @throws std::invalid_argument If a product does not exist or there is insufficient stock.
+     */
+    size_t sell_products(std::span<const order> orders);
+
+    /**
+     * @brief Removes a product from the warehouse.
+     *
+     * @param cipher Unique identifier of the product to remove.
+     * @return true if the product existed.
+     */
+    bool remove_product(std::string_view cipher);
+
+    /**
+     * @brief Returns the number of registered products.
+     */
+    size_t size() const { return product_table.size(); }
+
+    /**
+     * @brief Generates a report containing all products in the warehouse.
+     *
+     * Products are listed in the same order as warehouse::get_report(): registration order,
+     * except that removing a product moves the last listed one into its place. The other
+     * reports and for_each_product() use the same order.
+     *
+     * @return A formatted string listing all products and their details.
+     */
+    string get_report() const;
+
+    /**
+     * @brief Appends the report to a string, formatting every product in place.
+     *
+     * @param buffer The string to append to.
+     */
+    void write_report(string &buffer) const;
+
+    /**
+     * @brief Writes the report to a stream, one product at a time.
+     *
+     * @param os The stream to write to.
+     */
+    void write_report(std::ostream &os) const;
+
+    /**
+     * @brief Lists all products that are out of stock.
+     *
+     * @return A formatted string containing the names of products with zero quantity.
+     */
+    string missing_products() const;
+
+    /**
+     * @brief Calls @p f on every product with its concrete type.
+     *
+     * @param f Callback invoked as f(std::string_view cipher, const retail_product&) or
+     *          f(std::string_view cipher, const wholesale_product&).
+     */
+    template<typename F>
+    void for_each_product(F &&f) const {
+        for (const cipher_key &cipher : listing)
+            std::visit([&](const auto &concrete) { f(cipher.view(), concrete); }, product_table.find(cipher)->second.item);
+    }
+};
+
+} // namespace mgw
+
+#endif // VARIANT_WAREHOUSE_HPP_
@@ -1,57 +1,218 @@
 #include "warehouse.hpp"
 #include "../products/wholesale_product.hpp"
 #include "../products/retail_product.hpp"
-#include <stdexcept>
 #include <algorithm>
-#include <execution>
+#include <new>
+#include <stdexcept>
+#include <ranges>
 
 namespace mgw {
 
-void warehouse::register_product(const string &cipher, const product_components &pr){
-    auto pos = product_table.find(cipher);
-    if(pos != product_table.end()){
-        //add product check
-        product_table[cipher]->add_to_storage(pr.quantity);
+product_kind parse_product_kind(std::string_view type){
+    if(type == "wholesale")
+        return product_kind::wholesale;
+    if(type == "retail")
+        return product_kind::retail;
+    throw std::invalid_argument("Error: Incorrect product type");
+}
+
+std::shared_ptr<product> make_product(const product_components &pr, std::pmr::memory_resource *mr){
+    return make_product(parse_product_kind(pr.type), pr, mr);
+}
+
+std::shared_ptr<product> make_product(product_kind kind, const product_components &pr, std::pmr::memory_resource *mr){
+    // The polymorphic allocator also hands itself to the product (uses-allocator construction).
+    switch(kind){
+    case product_kind::wholesale:
+        return std::allocate_shared<wholesale_product>(std::pmr::polymorphic_allocator<wholesale_product>(mr),
+            pr.quantity, pr.cost, pr.name, pr.firm, pr.country, pr.num);
+    case product_kind::retail:
+        return std::allocate_shared<retail_product>(std::pmr::polymorphic_allocator<retail_product>(mr),
+            pr.quantity, pr.cost, pr.name, pr.firm, pr.country, pr.num);
     }
-    else if(pr.type == "wholesale"){
-        product_table[cipher] = std::make_shared<wholesale_product>(wholesale_product(
-            pr.quantity, pr.cost, pr.name, pr.firm, pr.country, pr.num
-        ));
+    throw std::invalid_argument("Error: Incorrect product type");
+}
+
+void warehouse::reserve(size_t n){
+    product_table.reserve(n);
+    columns.reserve(n);
+    listing.reserve(n);
+    if(cipher_filter && cipher_filter->capacity() < n)
+        rebuild_cipher_filter(filter_fp_rate, n);
+}
+
+void warehouse::register_product(std::string_view cipher, const product_components &pr){
+    // One hash and probe: the slot is claimed up front and filled in only for new ciphers.
+    auto [pos, inserted] = product_table.try_emplace(cipher);
+    if(!inserted){
+        //add product check
+        const size_t before = pos->second.item->get_quantity();
+        pos->second.item->add_to_storage(pr.quantity);
+        update_stock_index(pos->first, pos->second, before);
+        return;
     }
-    else if(pr.type == "retail"){
-        product_table[cipher] = std::make_shared<retail_product>(retail_product(
-            pr.quantity, pr.cost, pr.name, pr.firm, pr.country, pr.num
-        ));
+    // Each step either succeeds or leaves its structure as it was; on failure the steps
+    // that did succeed are undone, so no entry is left behind without a product or row.
+    const size_t row = columns.size();
+    try{
+        const product_kind kind = parse_product_kind(pr.type);
+        pos->second.item = make_product(kind, pr, resource);
+        pos->second.row = columns.insert(pos->first, kind, pr.quantity, pr.cost, pr.num);
+        listing.push_back(pos->second.item.get());
+        if(pos->second.item->get_quantity() == 0)
+            out_of_stock.try_emplace(pos->first, pos->second.item.get());
+        if(cipher_filter){
+            if(cipher_filter->size() >= cipher_filter->capacity())
+                rebuild_cipher_filter(filter_fp_rate);
+            else
+                cipher_filter->insert(pos->first.hash());
+        }
     }
-    else{
-        throw std::invalid_argument("Error: Incorrect product type");
+    catch(...){
+        out_of_stock.erase(cipher);
+        if(listing.size() > row)
+            listing.pop_back();
+        if(columns.size() > row)
+            columns.erase(row);
+        product_table.erase(cipher);
+        throw;
     }
 }
 
-size_t warehouse::sell_product(const string &cipher, const size_t num) {
+size_t warehouse::sell_product(std::string_view cipher, const size_t num) {
+	if (cipher_filter) {
+		++filter_counters.queries;
+		if (!cipher_filter->may_contain(mgc::fixed_key_hash()(cipher))) {
+			++filter_counters.rejected;
+			throw std::invalid_argument("Error: No such product");
+		}
+	}
 	auto pos = product_table.find(cipher);
-	if (pos != product_table.end())
-		return (*pos).second->sell(num);
-	else
-		throw std::invalid_argument("Error: No such product");
+	if (pos != product_table.end()) {
+		const size_t before = pos->second.item->get_quantity();
+		size_t price = pos->second.item->sell(num);
+		update_stock_index(pos->first, pos->second, before);
+		return price;
+	}
+	if (cipher_filter)
+		++filter_counters.false_positives;
+	throw std::invalid_argument("Error: No such product");
+}
+
+size_t warehouse::sell_products(std::span<const order> orders) {
+    // The orders up to the first one the filter rejects are looked up as a batch; that one
+    // then fails without a table probe, as it would in sell_product().
+    size_t looked_up = orders.size();
+    if (cipher_filter) {
+        for (size_t i = 0; i < orders.size(); ++i) {
+            if (!cipher_filter->may_contain(mgc::fixed_key_hash()(orders[i].cipher))) {
+                looked_up = i;
+                break;
+            }
+        }
+    }
+    size_t total = 0;
+    product_table.visit_many(orders.first(looked_up) | std::views::transform(&order::cipher), [&](size_t i, auto pos) {
+        if (cipher_filter)
+            ++filter_counters.queries;
+        if (pos == product_table.end()) {
+            if (cipher_filter)
+                ++filter_counters.false_positives;
+            throw std::invalid_argument("Error: No such product");
+        }
+        const size_t before = pos->second.item->get_quantity();
+        total += pos->second.item->sell(orders[i].num);
+        update_stock_index(pos->first, pos->second, before);
+    });
+    if (looked_up < orders.size()) {
+        ++filter_counters.queries;
+        ++filter_counters.rejected;
+        throw std::invalid_argument("Error: No such product");
+    }
+    return total;
+}
+
+bool warehouse::remove_product(std::string_view cipher){
+    auto pos = product_table.find(cipher);
+    if(pos == product_table.end())
+        return false;
+    const size_t row = pos->second.row;
+    if(pos->second.item->get_quantity() == 0)
+        out_of_stock.erase(cipher);
+    product_table.erase(cipher);
+    columns.erase(row);
+    listing[row] = listing.back();
+    listing.pop_back();
+    // The last row has moved into the freed one; point its product at the new position.
+    if(row < columns.size())
+        product_table.find(columns.cipher(row))->second.row = row;
+    // The filter cannot forget one key; rebuild once stale bits would take a quarter of it.
+    // The product is already gone, so a failed rebuild keeps the stale filter and is retried
+    // on the next removal; stale bits only cost extra false positives.
+    if(cipher_filter && ++filter_stale > cipher_filter->capacity() / 4){
+        try{
+            rebuild_cipher_filter(filter_fp_rate);
+        }
+        catch(const std::bad_alloc &){}
+    }
+    return true;
+}
+
+void warehouse::enable_cipher_filter(double fp_rate){
+    // The rate is kept only once a filter was built with it, so a rejected rate changes nothing.
+    rebuild_cipher_filter(fp_rate);
+    filter_fp_rate = fp_rate;
+    filter_counters = filter_stats();
+}
+
+void warehouse::disable_cipher_filter(){
+    cipher_filter.reset();
+    filter_stale = 0;
+}
+
+void warehouse::rebuild_cipher_filter(double fp_rate, size_t min_capacity){
+    constexpr size_t smallest = 64;
+    // Built aside and swapped in, so a failed allocation keeps the current filter.
+    mgc::BloomFilter fresh(std::max({smallest, min_capacity, product_table.size() * 2}), fp_rate);
+    for(auto &i : product_table)
+        fresh.insert(i.first.hash());
+    cipher_filter = std::move(fresh);
+    filter_stale = 0;
 }
 
 string warehouse::get_report()const{
     string result;
-    for(auto &i : product_table){
-        result += (i.second->get_Info() + '\n');
-    }
+    write_report(result);
     return result;
 }
 
+void warehouse::write_report(std::ostream &os)const{
+    report_lines([&os](std::string_view line) { os.write(line.data(), static_cast<std::streamsize>(line.size())); });
+}
+
+void warehouse::write_report(string &buffer)const{
+    for(const product *p : listing){
+        p->append_Info(buffer);
+        buffer += '\n';
+    }
+}
+
 string warehouse::missing_products()const{
     string result;
-    std::for_each(std::execution::par, product_table.begin(), product_table.end(), [&result](auto &x) {
-        if(x.second->get_quantity() == 0){
-            result += (x.second->get_name() + '\n');
-        }
-    });
+    for(const auto &[cipher, pr] : out_of_stock){
+        result += pr->get_name();
+        result += '\n';
+    }
     return result;
 }
 
+void warehouse::update_stock_index(const cipher_key &cipher, const product_slot &slot, size_t before){
+    const size_t now = slot.item->get_quantity();
+    columns.set_quantity(slot.row, now);
+    if(now == 0 && before != 0)
+        out_of_stock.try_emplace(cipher, slot.item.get());
+    else if(now != 0 && before == 0)
+        out_of_stock.erase(cipher);
+}
+
 }
\ No newline at end of file
@@ -2,9 +2,22 @@
 #define WAREHOUSE_HPP_
 
 #include "../products/product.hpp"
+#include <algorithm>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ostream>
+#include <span>
 #include <string>
-#include "../container/unordered_map.hpp"
+#include <string_view>
+#include <vector>
+#include "../container/bloom_filter.hpp"
+#include "../container/dense_hash_map.hpp"
+#include "../container/fixed_key.hpp"
+#include "../container/flat_hash_map.hpp"
+#include "inventory_columns.hpp"
+#include "product_key.hpp"
 
 using std::string;
 
@@ -24,12 +37,125 @@ struct product_components {
     string type;     ///< Product type (wholesale/retail).
 };
 
+/**
+ * @brief Parses a product type name ("retail" or "wholesale").
+ * 
+ * @param type The type name, as in product_components::type.
+ * @return The product kind.
+ * @throws std::invalid_argument If the type name is unknown.
+ */
+product_kind parse_product_kind(std::string_view type);
+
+/**
+ * @brief Creates a product from its components.
+ * 
+ * The shared pointer's control block, the product and its name are all allocated from
+ * @p mr, which must outlive the product.
+ * 
+ * @param pr Struct containing product details.
+ * @param mr Memory resource for the product (default is the default resource).
+ * @return The new product.
+ * @throws std::invalid_argument If the product type is neither "wholesale" nor "retail".
+ */
+std::shared_ptr<product> make_product(const product_components &pr,
+                                      std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+/**
+ * @brief Creates a product of an already parsed kind from its components.
+ * 
+ * Like make_product(const product_components&, std::pmr::memory_resource*), but
+ * product_components::type is not looked at.
+ * 
+ * @param kind The kind of product to create.
+ * @param pr Struct containing product details.
+ * @param mr Memory resource for the product (default is the default resource).
+ * @return The new product.
+ */
+std::shared_ptr<product> make_product(product_kind kind, const product_components &pr,
+                                      std::pmr::memory_resource *mr = std::pmr::get_default_resource());
+
+/**
+ * @struct order
+ * @brief One line of a sell batch.
+ */
+struct order {
+    std::string_view cipher; ///< Unique identifier of the product to be sold.
+    size_t num;              ///< The number of units (or wholesale batches) to sell.
+};
+
+/**
+ * @struct filter_stats
+ * @brief Counters of the cipher filter, for tuning its false-positive rate.
+ */
+struct filter_stats {
+    size_t queries = 0;         ///< Lookups checked against the filter.
+    size_t rejected = 0;        ///< Lookups the filter rejected without touching the table.
+    size_t false_positives = 0; ///< Lookups the filter passed that the table then missed.
+
+    /**
+     * @brief Returns the share of unknown ciphers that got past the filter.
+     */
+    double false_positive_rate() const {
+        size_t misses = rejected + false_positives;
+        return misses ? static_cast<double>(false_positives) / static_cast<double>(misses) : 0.0;
+    }
+};
+
 /**
  * @class warehouse
  * @brief Represents a warehouse that manages a collection of products.
  */
 class warehouse {
-    mgc::HashMap<string, std::shared_ptr<product>> product_table; ///< Storage for products, mapped by their cipher.
+    /**
+     * @brief A product and its row in the inventory columns.
+     */
+    struct product_slot {
+        std::shared_ptr<product> item; ///< The product.
+        size_t row = 0;                ///< Row of the product in columns.
+    };
+
+    mgc::FlatHashMap<cipher_key, product_slot, mgc::fixed_key_hash> product_table; ///< Storage for products, mapped by their cipher.
+    std::optional<mgc::BloomFilter> cipher_filter; ///< Optional front that rejects unknown ciphers before the table lookup.
+    double filter_fp_rate = 0.01;                  ///< Target false-positive rate of the filter.
+    size_t filter_stale = 0;                       ///< Removed ciphers whose bits are still set in the filter.
+    filter_stats filter_counters;                  ///< Filter counters since the filter was enabled or reset.
+    mgc::DenseHashMap<cipher_key, const product*, mgc::fixed_key_hash> out_of_stock; ///< Products with zero quantity, kept in sync with every stock change.
+    inventory_columns columns; ///< Numeric product fields by column, kept in sync with every change.
+    std::vector<const product*> listing; ///< Product of each column row, in row order: the order of reports.
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource(); ///< Memory resource for products and their names.
+
+    /**
+     * @brief Records a stock change: updates the quantity column, and the out-of-stock
+     *        index if the quantity crossed zero.
+     * 
+     * @param cipher The cipher of the product.
+     * @param slot The product's table entry.
+     * @param before The quantity before the change.
+     */
+    void update_stock_index(const cipher_key &cipher, const product_slot &slot, size_t before);
+
+    /**
+     * @brief Calls @p emit with each report line, formatted into one reused buffer.
+     */
+    template<typename F>
+    void report_lines(F &&emit) const {
+        string line;
+        for (const product *p : listing) {
+            line.clear();
+            p->append_Info(line);
+            line += '\n';
+            emit(std::string_view(line));
+        }
+    }
+
+    /**
+     * @brief Rebuilds the cipher filter from the table, sized for twice the current number of products.
+     * 
+     * @param fp_rate      Target false-positive rate of the new filter.
+     * @param min_capacity Minimum number of products the new filter is sized for.
+     * @throws std::invalid_argument If @p fp_rate is not in (0, 1); the current filter is kept.
+     */
+    void rebuild_cipher_filter(double fp_rate, size_t min_capacity = 0);
 
 public:
     /**
@@ -39,39 +165,170 @@ public:
      */
     warehouse() = default;
 
+    /**
+     * @brief Constructs an empty warehouse whose products are allocated from a memory resource.
+     * 
+     * Every product, its name and its shared pointer control block come from @p mr, so a
+     * catalog can be built into a std::pmr::monotonic_buffer_resource (or a pool) and
+     * released in one step. The tables themselves use the global heap. @p mr must outlive
+     * the warehouse.
+     * 
+     * @param mr The memory resource for products.
+     */
+    explicit warehouse(std::pmr::memory_resource *mr) : resource(mr) {}
+
+    /**
+     * @brief Returns the memory resource products are allocated from.
+     */
+    std::pmr::memory_resource* get_memory_resource() const { return resource; }
+
+    /**
+     * @brief Makes room for @p n products.
+     * 
+     * Afterwards, registering new products up to a total of @p n grows no table, so each
+     * registration allocates only the product itself from the warehouse's memory resource
+     * (plus its name, if that does not fit the small-string buffer).
+     * 
+     * @param n The number of products to make room for.
+     */
+    void reserve(size_t n);
+
     /**
      * @brief Registers a new product in the warehouse.
      * 
      * If a product with the given cipher already exists, its details are updated.
+     * The cipher is only copied into a cipher_key when a new product is added.
      * 
      * @param cipher Unique identifier for the product.
      * @param pr Struct containing product details.
+     * @throws std::length_error If the cipher is longer than cipher_key::max_size.
      */
-    void register_product(const string &cipher, const product_components &pr);
+    void register_product(std::string_view cipher, const product_components &pr);
 
     /**
      * @brief Processes the sale of a product.
      * 
+     * Looks the cipher up without allocating, so it may point straight into a parsed buffer.
+     * 
+     * With the cipher filter enabled, most unknown ciphers are rejected by the filter
+     * without a table lookup.
+     * 
      * @param cipher Unique identifier of the product to be sold.
      * @param num The number of units (or wholesale batches) to sell.
      * @return The total sale price.
      * @throws std::runtime_error If the product does not exist or there is insufficient stock.
      */
-    size_t sell_product(const string &cipher, const size_t num);
+    size_t sell_product(std::string_view cipher, const size_t num);
+
+    /**
+     * @brief Processes a batch of sales.
+     * 
+     * Equivalent to calling sell_product() for each order in turn, but the ciphers are
+     * looked up in prefetched blocks so the batch overlaps its memory latency.
+     * If an order fails, the orders before it stay sold. The cipher filter and its
+     * counters apply to every order as they do in sell_product().
+     * 
+     * @param orders The orders to process, in order.
+     * @return The total sale price of all orders.
+     * @throws std::invalid_argument If a product does not exist or there is insufficient stock.
+     */
+    size_t sell_products(std::span<const order> orders);
 
     /**
      * @brief Generates a report containing all available products in the warehouse.
      * 
+     * Products are listed in registration order, except that removing a product moves the
+     * last listed one into its place (the row order of inventory()). The order depends only
+     * on the sequence of registrations and removals, never on hashing, so the same
+     * operations always produce the same report. The write_report() overloads use the same order.
+     * 
      * @return A formatted string listing all products and their details.
      */
     string get_report() const;
 
+    /**
+     * @brief Writes the report to a stream, one product at a time.
+     * 
+     * Each line is formatted into a single reused buffer, so the extra memory does not
+     * depend on the size of the catalog.
+     * 
+     * @param os The stream to write to.
+     */
+    void write_report(std::ostream &os) const;
+
+    /**
+     * @brief Appends the report to a string, formatting every product in place.
+     * 
+     * Reusing the same string across reports avoids reallocating it.
+     * 
+     * @param buffer The string to append to.
+     */
+    void write_report(string &buffer) const;
+
+    /**
+     * @brief Writes the report through an output iterator, one product at a time.
+     * 
+     * @param out The iterator to write the characters to.
+     * @return The iterator past the last character written.
+     */
+    template<typename OutputIt>
+        requires std::output_iterator<OutputIt, char>
+    OutputIt write_report(OutputIt out) const {
+        report_lines([&out](std::string_view line) { out = std::copy(line.begin(), line.end(), out); });
+        return out;
+    }
+
     /**
      * @brief Lists all products that are out of stock.
      * 
+     * Reads an index maintained on every stock change, so the cost is proportional to the
+     * number of missing products, not to the size of the catalog.
+     * 
      * @return A formatted string containing the names of products with zero quantity.
      */
     string missing_products() const;
+
+    /**
+     * @brief Returns the columnar view of the inventory, for catalog-wide aggregates.
+     * 
+     * Always up to date with the products in the warehouse.
+     */
+    const inventory_columns& inventory() const { return columns; }
+
+    /**
+     * @brief Removes a product from the warehouse.
+     * 
+     * @param cipher Unique identifier of the product to remove.
+     * @return true if the product existed.
+     */
+    bool remove_product(std::string_view cipher);
+
+    /**
+     * @brief Enables the probabilistic cipher filter in front of sell_product().
+     * 
+     * The filter is built from the current products and kept in sync by register_product()
+     * and remove_product(). It is rebuilt automatically when it fills up or when many
+     * removed ciphers still occupy it. Enabling it again rebuilds it and resets the counters.
+     * 
+     * @param fp_rate Target false-positive rate, in (0, 1) (default is 0.01).
+     * @throws std::invalid_argument If @p fp_rate is not in (0, 1); the filter and its rate stay as they were.
+     */
+    void enable_cipher_filter(double fp_rate = 0.01);
+
+    /**
+     * @brief Disables the cipher filter and frees its memory.
+     */
+    void disable_cipher_filter();
+
+    /**
+     * @brief Returns the filter counters since the filter was enabled or the counters were reset.
+     */
+    filter_stats cipher_filter_stats() const { return filter_counters; }
+
+    /**
+     * @brief Resets the filter counters.
+     */
+    void reset_cipher_filter_stats() { filter_counters = filter_stats(); }
 };
 
 } // namespace mgw
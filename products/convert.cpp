@@ -3,10 +3,10 @@
 
 namespace mgw {
     wholesale_product retail_product::change_to_wholesale(size_t wholesale_size){
-        return wholesale_product(quantity, cost, name, firm, country, wholesale_size);
+        return wholesale_product(quantity, cost, name, firm.view(), country.view(), wholesale_size);
     }
 
     retail_product wholesale_product::change_to_retail(size_t allowance){
-        return retail_product(quantity, cost, name, firm, country, allowance);
+        return retail_product(quantity, cost, name, firm.view(), country.view(), allowance);
     }
 }
\ No newline at end of file
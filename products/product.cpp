@@ -1,9 +1,16 @@
 #include "product.hpp"
 #include <format>
+#include <iterator>
 namespace mgw {
     string product::get_Info()const{
-        return std::format(
+        string result;
+        append_Info(result);
+        return result;
+    }
+
+    void product::append_Info(string &out, size_t q)const{
+        std::format_to(std::back_inserter(out),
             "[Name: {}] | Quantity: {} | Manufacturer: {} ({}) | Price: {} | Type: {}_product",
-            name, quantity, firm, country, cost, type);
+            name, q, firm.view(), country.view(), cost, type.view());
     }
 }
\ No newline at end of file
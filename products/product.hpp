@@ -2,8 +2,12 @@
 #define PRODUCT_HPP_
 
 #include <string>
+#include <string_view>
 #include <cstdlib>
+#include <memory_resource>
 #include <ostream>
+#include <utility>
+#include "../container/string_pool.hpp"
 
 using std::string;
 using std::ostream;
@@ -16,44 +20,81 @@ namespace mgw {
  * @brief Base class representing a product in the warehouse.
  */
 class product {
+public:
+    /// Allocator for the storage owned by the product (its name). Products follow the uses-allocator protocol.
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
 protected:
     size_t quantity;  ///< Quantity of the product in stock.
     size_t cost;      ///< Cost per unit of the product.
-    const string name;    ///< Name of the product.
-    const string firm;    ///< Manufacturer of the product.
-    const string country; ///< Country of the manufacturer.
-    const string type;    ///< Type of product (wholesale/retail).
+    const std::pmr::string name;       ///< Name of the product, allocated from the product's memory resource.
+    const mgc::InternedString firm;    ///< Manufacturer of the product, interned in the global pool.
+    const mgc::InternedString country; ///< Country of the manufacturer, interned in the global pool.
+    const mgc::InternedString type;    ///< Type of product (wholesale/retail), interned in the global pool.
 
 public:
     /**
      * @brief Default constructor.
      * @param tp Product type (default is an empty string).
+     * @param alloc Allocator for the product's storage.
      */
-    product(string tp = "") : quantity{}, cost{}, name{}, firm{}, country{}, type{tp} {}
+    product(std::string_view tp = "", const allocator_type &alloc = {})
+        : quantity{}, cost{}, name{alloc}, firm{}, country{}, type{intern(tp)} {}
 
     /**
      * @brief Parameterized constructor.
+     * 
+     * Firm, country and type are interned: every product with the same manufacturer
+     * shares one copy of its name.
+     * 
      * @param tp Product type.
      * @param q Quantity of the product.
      * @param c Cost per unit.
      * @param n Name of the product.
      * @param f Manufacturer of the product.
      * @param cn Country of the manufacturer.
+     * @param alloc Allocator for the product's storage.
      */
-    product(string tp, size_t q, size_t c, string &n, string &f, string &cn)
-        : quantity(q), cost(c), name(n), firm(f), country(cn), type(tp) {}
+    product(std::string_view tp, size_t q, size_t c, std::string_view n, std::string_view f, std::string_view cn,
+            const allocator_type &alloc = {})
+        : quantity(q), cost(c), name(n, alloc), firm(intern(f)), country(intern(cn)), type(intern(tp)) {}
+
+    /**
+     * @brief Interns a string in the pool shared by all products.
+     */
+    static mgc::InternedString intern(std::string_view s) { return mgc::StringPool::global().intern(s); }
 
     /**
      * @brief Gets the product type.
-     * @return A constant reference to the product type.
+     * @return A view of the product type.
      */
-    const string& get_type() const { return type; }
+    std::string_view get_type() const { return type.view(); }
+
+    /**
+     * @brief Gets the manufacturer.
+     * 
+     * Products with the same manufacturer have equal handles, so grouping is an integer compare.
+     * 
+     * @return The interned manufacturer name.
+     */
+    mgc::InternedString get_firm() const { return firm; }
+
+    /**
+     * @brief Gets the country of the manufacturer.
+     * @return The interned country name.
+     */
+    mgc::InternedString get_country() const { return country; }
 
     /**
      * @brief Gets the product name.
-     * @return A constant reference to the product name.
+     * @return A view of the product name.
+     */
+    std::string_view get_name() const { return name; }
+
+    /**
+     * @brief Gets the allocator the product's storage comes from.
      */
-    const string& get_name() const { return name; }
+    allocator_type get_allocator() const { return name.get_allocator(); }
 
     /**
      * @brief Gets the quantity of the product in stock.
@@ -71,7 +112,26 @@ public:
      * @brief Retrieves product information as a formatted string.
      * @return A string containing detailed product information.
      */
-    virtual string get_Info() const;
+    string get_Info() const;
+
+    /**
+     * @brief Appends product information to a string, formatting in place.
+     * 
+     * Allocates only if @p out has to grow, so a reused buffer makes repeated calls allocation-free.
+     * 
+     * @param out The string to append to.
+     */
+    void append_Info(string &out) const { append_Info(out, quantity); }
+
+    /**
+     * @brief Appends product information to a string, reporting a given quantity in stock.
+     * 
+     * For owners that keep the stock outside the product (see concurrent_warehouse).
+     * 
+     * @param out The string to append to.
+     * @param q The quantity to report.
+     */
+    virtual void append_Info(string &out, size_t q) const;
 
     /**
      * @brief Prints product information to the specified output stream.
@@ -83,8 +143,21 @@ public:
         return ost;
     }
 
+    /**
+     * @brief Returns the number of units in stock that an order takes.
+     * @param amount The amount ordered, as passed to sell().
+     */
+    virtual size_t stock_units(size_t amount) const = 0;
+
+    /**
+     * @brief Returns the price of an order without changing the stock.
+     * @param amount The amount ordered, as passed to sell().
+     */
+    virtual size_t price(size_t amount) const = 0;
+
     /**
      * @brief Processes a sale of the product.
+     * 
      * @param amount The amount of product to sell.
      * @return The total sale cost.
      * @throws std::runtime_error If the requested quantity exceeds available stock.
@@ -1,5 +1,6 @@
 #include "retail_product.hpp"
 #include <format>
+#include <iterator>
 #include <stdexcept>
 
 namespace mgw {
@@ -8,12 +9,17 @@ size_t retail_product::sell(size_t num){
     if(get_quantity() < num)
         throw std::invalid_argument("Error: Insufficient quantity");
     quantity -= num;
+    return price(num);
+}
+
+size_t retail_product::price(size_t num)const{
     return num * static_cast<size_t>(static_cast<float>(cost) * 
                             static_cast<float>(allowance) * 0.01);
 }
 
-string retail_product::get_Info()const{
-    return std::format("{} | Allowance: {}%", product::get_Info(), allowance);
+void retail_product::append_Info(string &out, size_t q)const{
+    product::append_Info(out, q);
+    std::format_to(std::back_inserter(out), " | Allowance: {}%", allowance);
 }
 
 }
\ No newline at end of file
@@ -15,7 +15,7 @@ class wholesale_product;
  * Inherits from the `product` class and includes an additional 
  * allowance percentage that affects the retail price.
  */
-class retail_product : public product {
+class retail_product final : public product {
     size_t allowance; ///< The retail markup percentage.
 
 public:
@@ -35,10 +35,12 @@ public:
      * @param f Manufacturer name.
      * @param cn Country of manufacture.
      * @param a Allowance (markup percentage).
+     * @param alloc Allocator for the product's storage.
      * @throws std::invalid_argument If the allowance exceeds 100%.
      */
-    retail_product(size_t q, size_t c, string n, string f, string cn, size_t a) 
-        : product("retail", q, c, n, f, cn), allowance(a) {
+    retail_product(size_t q, size_t c, std::string_view n, std::string_view f, std::string_view cn, size_t a,
+                   const allocator_type &alloc = {})
+        : product("retail", q, c, n, f, cn, alloc), allowance(a) {
         if (allowance > 100)
             throw std::invalid_argument("Error: Allowance can't exceed one hundred");
     }
@@ -79,6 +81,16 @@ public:
      */
     size_t sell(size_t num) override;
 
+    /**
+     * @brief Returns the number of units an order takes: @p num itself.
+     */
+    size_t stock_units(size_t num) const override { return num; }
+
+    /**
+     * @brief Returns the price of @p num units including the markup.
+     */
+    size_t price(size_t num) const override;
+
     /**
      * @brief Converts the retail product into a wholesale product.
      * 
@@ -87,11 +99,14 @@ public:
      */
     wholesale_product change_to_wholesale(size_t wholesale_size);
 
+    using product::append_Info;
+
     /**
-     * @brief Retrieves detailed information about the retail product.
-     * @return A formatted string containing product details.
+     * @brief Appends detailed information about the retail product to a string.
+     * @param out The string to append to.
+     * @param q The quantity to report.
      */
-    string get_Info() const override;
+    void append_Info(string &out, size_t q) const override;
 };
 
 } // namespace mgw
@@ -1,16 +1,18 @@
 #include "wholesale_product.hpp"
 #include <format>
+#include <iterator>
 namespace mgw {
 
 size_t wholesale_product::sell(size_t amount){
-    if(quantity < amount * wholesale_size)
+    if(quantity < stock_units(amount))
         throw std::invalid_argument("Error: Insufficient quantity");
-    quantity -= amount * wholesale_size;
-    return amount * wholesale_size * cost;
+    quantity -= stock_units(amount);
+    return price(amount);
 }
 
-string wholesale_product::get_Info()const{
-    return std::format("{} | Wholesale_size: {}", product::get_Info(), wholesale_size);
+void wholesale_product::append_Info(string &out, size_t q)const{
+    product::append_Info(out, q);
+    std::format_to(std::back_inserter(out), " | Wholesale_size: {}", wholesale_size);
 }
 
 }
\ No newline at end of file
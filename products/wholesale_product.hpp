@@ -13,7 +13,7 @@ class retail_product;
  * 
  * Inherits from the `product` class and includes an additional field for wholesale batch size.
  */
-class wholesale_product : public product {
+class wholesale_product final : public product {
 private:
     size_t wholesale_size; ///< The number of units in a wholesale batch.
 
@@ -34,9 +34,11 @@ public:
      * @param f Manufacturer name.
      * @param cn Country of manufacture.
      * @param ws Wholesale batch size (number of items per batch).
+     * @param alloc Allocator for the product's storage.
      */
-    wholesale_product(size_t q, size_t c, string n, string f, string cn, size_t ws) 
-        : product("wholesale", q, c, n, f, cn), wholesale_size(ws) {}
+    wholesale_product(size_t q, size_t c, std::string_view n, std::string_view f, std::string_view cn, size_t ws,
+                      const allocator_type &alloc = {})
+        : product("wholesale", q, c, n, f, cn, alloc), wholesale_size(ws) {}
 
     /**
      * @brief Sets the wholesale batch size.
@@ -60,13 +62,23 @@ public:
      */
     size_t sell(size_t amount) override;
 
+    /**
+     * @brief Returns the number of units an order takes: @p amount whole batches.
+     */
+    size_t stock_units(size_t amount) const override { return amount * wholesale_size; }
+
+    /**
+     * @brief Returns the price of @p amount batches.
+     */
+    size_t price(size_t amount) const override { return amount * wholesale_size * cost; }
+
     /**
      * @brief Adds stock to the storage.
      * 
      * @param amount The number of additional wholesale batches.
      * The total quantity added is `amount * wholesale_size`.
      */
-    void add_to_storage(size_t amount) override { quantity += amount * wholesale_size; }
+    void add_to_storage(size_t amount) override { quantity += stock_units(amount); }
 
     /**
      * @brief Converts the wholesale product into a retail product.
@@ -76,11 +88,14 @@ public:
      */
     retail_product change_to_retail(size_t allowance);
 
+    using product::append_Info;
+
     /**
-     * @brief Retrieves detailed information about the wholesale product.
-     * @return A formatted string containing product details.
+     * @brief Appends detailed information about the wholesale product to a string.
+     * @param out The string to append to.
+     * @param q The quantity to report.
      */
-    string get_Info() const override;
+    void append_Info(string &out, size_t q) const override;
 };
 
 } // namespace mgw
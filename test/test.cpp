@@ -654,4 +654,1573 @@ TEST_CASE("Const Iterator Functionality", "[HashMap]") {
     REQUIRE(find_it->second == "twenty");
 
     // Note: Dereferencing c_map.end() is undefined, so we only check equality.
-}
\ No newline at end of file
+}
+TEST_CASE("Incremental Rehash", "[HashMap]") {
+    HashMap<int, int> map(5, 1.0);
+    map.set_incremental_rehash(true);
+
+    bool saw_migration = false;
+    for (int i = 0; i < 2000; ++i) {
+        map.insert(i, i);
+        saw_migration = saw_migration || map.rehash_in_progress();
+        // Every key stays reachable while buckets are split between two arrays.
+        if (i % 97 == 0)
+            for (int j = 0; j <= i; ++j)
+                REQUIRE(map.find(j) != map.end());
+    }
+    REQUIRE(saw_migration);
+    REQUIRE(map.size() == 2000);
+
+    // Erase and update while a migration may be in flight.
+    for (int i = 0; i < 2000; i += 3)
+        map.erase(i);
+    for (int i = 1; i < 2000; i += 3)
+        map[i] = -i;
+    for (int i = 0; i < 2000; ++i) {
+        auto it = map.find(i);
+        if (i % 3 == 0)
+            REQUIRE(it == map.end());
+        else
+            REQUIRE(it->second == (i % 3 == 1 ? -i : i));
+    }
+
+    // Insertion order is untouched by migration.
+    int prev = -1;
+    for (auto &kv : map) {
+        REQUIRE(kv.first > prev);
+        prev = kv.first;
+    }
+
+    // Turning the mode off completes any pending migration.
+    map.set_incremental_rehash(false);
+    REQUIRE_FALSE(map.rehash_in_progress());
+    HashMap<int, int> copy(map);
+    REQUIRE(copy.size() == map.size());
+    REQUIRE(copy.find(1)->second == -1);
+}
+
+// Allocator that counts live allocations, used to observe node pool slabs.
+struct AllocStats {
+    size_t allocations = 0;
+    size_t live = 0;
+};
+
+template<typename T>
+struct CountingAllocator {
+    using value_type = T;
+    AllocStats* stats;
+
+    explicit CountingAllocator(AllocStats* s) : stats(s) {}
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U>& other) : stats(other.stats) {}
+
+    T* allocate(size_t n) {
+        ++stats->allocations;
+        ++stats->live;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        --stats->live;
+        std::allocator<T>().deallocate(p, n);
+    }
+    template<typename U>
+    bool operator==(const CountingAllocator<U>& other) const { return stats == other.stats; }
+};
+
+TEST_CASE("Node pool", "[HashMap]") {
+    AllocStats stats;
+    using Alloc = CountingAllocator<std::pair<const int, int>>;
+    HashMap<int, int, std::hash<int>, mgc::modulo_policy, Alloc> map(11, 1.0, Alloc(&stats));
+
+    for (int i = 0; i < 1000; ++i)
+        map.insert(i, i);
+    // Nodes come from a handful of slabs, not one allocation each.
+    REQUIRE(stats.allocations < 20);
+
+    // Erase/insert churn reuses freed nodes without touching the allocator.
+    size_t before = stats.allocations;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 1000; ++i)
+            map.erase(i);
+        for (int i = 0; i < 1000; ++i)
+            map.insert(i, i + round);
+    }
+    REQUIRE(stats.allocations == before);
+    REQUIRE(map.find(999)->second == 999 + 9);
+
+    // clear() hands every slab back.
+    map.clear();
+    REQUIRE(stats.live == 0);
+    map.insert(1, 1);
+    REQUIRE(map.find(1)->second == 1);
+}
+
+#include "../container/flat_hash_map.hpp"
+
+using mgc::FlatHashMap;
+
+static_assert(std::bidirectional_iterator<typename FlatHashMap<int, int>::iterator>,
+              "FlatHashMap::iterator does not satisfy bidirectional_iterator");
+static_assert(std::bidirectional_iterator<typename FlatHashMap<int, int>::const_iterator>,
+              "FlatHashMap::const_iterator does not satisfy bidirectional_iterator");
+
+TEST_CASE("FlatHashMap: Insertion, Lookup and Erase", "[FlatHashMap]") {
+    FlatHashMap<std::string, int> map;
+    REQUIRE(map.size() == 0);
+    REQUIRE(map.find("absent") == map.end());
+
+    map.insert("one", 1);
+    map.insert("two", 2);
+    map["three"] = 3;
+    REQUIRE(map.size() == 3);
+    REQUIRE(map.find("two")->second == 2);
+    REQUIRE(map["three"] == 3);
+
+    // Update existing key using insert.
+    map.insert("two", 22);
+    REQUIRE(map.size() == 3);
+    REQUIRE(map.find("two")->second == 22);
+
+    map.erase("two");
+    map.erase("missing");
+    REQUIRE(map.size() == 2);
+    REQUIRE(map.find("two") == map.end());
+    REQUIRE(map.find("one")->second == 1);
+}
+
+TEST_CASE("FlatHashMap: Growth and tombstone reuse", "[FlatHashMap]") {
+    FlatHashMap<int, int> map(0);
+    for (int i = 0; i < 1000; ++i)
+        map.insert(i, i * 2);
+    REQUIRE(map.size() == 1000);
+    REQUIRE(map.load_factor() <= 0.875);
+    for (int i = 0; i < 1000; ++i) {
+        auto it = map.find(i);
+        REQUIRE(it != map.end());
+        REQUIRE(it->second == i * 2);
+    }
+
+    // Churn: erase and re-insert many times; the table must stay consistent.
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 1000; i += 2)
+            map.erase(i);
+        REQUIRE(map.size() == 500);
+        for (int i = 0; i < 1000; i += 2)
+            map.insert(i, i + round);
+        REQUIRE(map.size() == 1000);
+    }
+    for (int i = 1; i < 1000; i += 2)
+        REQUIRE(map.find(i)->second == i * 2);
+
+    // Manual rehash cannot shrink below the element count.
+    map.rehash(1);
+    REQUIRE(map.size() == 1000);
+    REQUIRE(map.find(999) != map.end());
+}
+
+TEST_CASE("FlatHashMap: Iteration, copy and move", "[FlatHashMap]") {
+    FlatHashMap<int, int> map;
+    for (int i = 1; i <= 100; ++i)
+        map.insert(i, i);
+
+    int sum = std::accumulate(map.begin(), map.end(), 0,
+                              [](int acc, const std::pair<const int, int>& p) { return acc + p.second; });
+    REQUIRE(sum == 5050);
+
+    // Reverse traversal visits the same number of elements.
+    size_t visited = 0;
+    for (auto it = map.end(); it != map.begin(); ) {
+        --it;
+        ++visited;
+    }
+    REQUIRE(visited == 100);
+
+    FlatHashMap<int, int> copy(map);
+    REQUIRE(copy.size() == 100);
+    copy.insert(1, -1);
+    REQUIRE(map.find(1)->second == 1);
+    REQUIRE(copy.find(1)->second == -1);
+
+    FlatHashMap<int, int> moved(std::move(map));
+    REQUIRE(moved.size() == 100);
+    REQUIRE(map.size() == 0);
+    REQUIRE(map.find(1) == map.end());
+    map[7] = 7;  // A moved-from map is still usable.
+    REQUIRE(map.size() == 1);
+
+    const FlatHashMap<int, int>& c_map = moved;
+    REQUIRE(c_map.find(50)->second == 50);
+    REQUIRE(c_map.cbegin() == c_map.begin());
+    REQUIRE(c_map.cend() == c_map.end());
+}
+
+/// A value whose copies and moves can be made to throw: the n-th one from now throws.
+struct throwing_copy {
+    static inline int countdown = 0;
+    static inline int live = 0;   // constructed and not yet destroyed
+    int v = 0;
+    throwing_copy(int x = 0) : v(x) { ++live; }
+    throwing_copy(const throwing_copy &o) : v(o.v) { tick(); ++live; }
+    throwing_copy(throwing_copy &&o) : v(o.v) { tick(); ++live; }
+    throwing_copy& operator=(const throwing_copy &) = default;
+    ~throwing_copy() { --live; }
+    static void tick() {
+        if (countdown > 0 && --countdown == 0)
+            throw std::runtime_error("copy failed");
+    }
+};
+
+TEST_CASE("FlatHashMap: a throwing rehash leaves the map unchanged", "[FlatHashMap]") {
+    FlatHashMap<std::string, throwing_copy> map(16);
+    size_t n = 0;
+    for (; map.size() < 14; ++n)
+        map.try_emplace("key" + std::to_string(n), static_cast<int>(n + 1));
+    const size_t cap = map.bucket_count();
+    throwing_copy::countdown = 4;
+    REQUIRE_THROWS_AS(map.rehash(cap * 4), std::runtime_error);
+    throwing_copy::countdown = 0;
+    REQUIRE(map.size() == 14);
+    REQUIRE(map.bucket_count() == cap);
+    for (size_t i = 0; i < n; ++i) {
+        auto it = map.find("key" + std::to_string(i));
+        REQUIRE(it != map.end());
+        REQUIRE(it->second.v == static_cast<int>(i + 1));
+    }
+    map.rehash(cap * 4);   // succeeds once copies stop failing
+    REQUIRE(map.size() == 14);
+    REQUIRE(map.find("key13")->second.v == 14);
+}
+
+TEST_CASE("FlatHashMap: a throwing copy frees what it built", "[FlatHashMap]") {
+    using map_type = FlatHashMap<std::string, throwing_copy>;
+    map_type map(16);
+    for (int i = 0; i < 14; ++i)
+        map.try_emplace("key" + std::to_string(i), i + 1);
+    const int before = throwing_copy::live;
+    throwing_copy::countdown = 8;
+    REQUIRE_THROWS_AS(map_type(map), std::runtime_error);
+    throwing_copy::countdown = 0;
+    REQUIRE(throwing_copy::live == before);
+    map_type copy(map);   // succeeds once copies stop failing
+    REQUIRE(copy.size() == 14);
+    REQUIRE(copy.find("key13")->second.v == 14);
+}
+
+TEST_CASE("FlatHashMap: a tiny load factor still grows", "[FlatHashMap]") {
+    FlatHashMap<int, int> map(16, 0.01);
+    for (int i = 0; i < 1000; ++i)
+        map.insert(i, i);
+    REQUIRE(map.size() == 1000);
+    for (int i = 0; i < 1000; ++i)
+        REQUIRE(map.find(i)->second == i);
+    REQUIRE(map.load_factor() <= 0.01);
+
+    FlatHashMap<int, int> lazy(0, 0.01);   // no table until the first insert
+    lazy.insert(1, 1);
+    REQUIRE(lazy.find(1)->second == 1);
+
+    REQUIRE_THROWS_AS((FlatHashMap<int, int>(16, 0.0)), std::invalid_argument);
+    REQUIRE_THROWS_AS((FlatHashMap<int, int>(16, -1.0)), std::invalid_argument);
+    REQUIRE_THROWS_AS((FlatHashMap<int, int>(16, 1.5)), std::invalid_argument);
+}
+
+TEST_CASE("Heterogeneous lookup", "[HashMap][FlatHashMap]") {
+    std::string_view view = std::string_view("xxCIPHER-1yy").substr(2, 8);
+
+    HashMap<std::string, int, mgc::string_hash> map;
+    map.insert("CIPHER-1", 1);
+    map.insert("CIPHER-2", 2);
+    REQUIRE(map.find(view) != map.end());
+    REQUIRE(map.find(view)->second == 1);
+    REQUIRE(map.contains("CIPHER-2"));
+    REQUIRE_FALSE(map.contains(std::string_view("CIPHER-3")));
+    map.erase(view);
+    REQUIRE(map.size() == 1);
+    REQUIRE_FALSE(map.contains(view));
+
+    FlatHashMap<std::string, int, mgc::string_hash> flat;
+    flat.insert("CIPHER-1", 1);
+    flat.insert("CIPHER-2", 2);
+    REQUIRE(flat.find(view)->second == 1);
+    REQUIRE(flat.contains("CIPHER-2"));
+    flat.erase(view);
+    REQUIRE(flat.size() == 1);
+    REQUIRE_FALSE(flat.contains(view));
+}
+
+TEST_CASE("Warehouse: string_view ciphers", "[warehouse]") {
+    mgw::warehouse wh;
+    mgw::product_components pc{10, 100, 20, "Widget", "ACME", "USA", "retail"};
+    const char buffer[] = "ORDER R-77;QTY 2";
+    std::string_view cipher(buffer + 6, 4);
+
+    wh.register_product(cipher, pc);
+    REQUIRE(wh.sell_product(std::string("R-77"), 2) == 40);
+    REQUIRE(wh.sell_product(cipher, 1) == 20);
+    REQUIRE_THROWS_AS(wh.sell_product(std::string_view(buffer, 5), 1), std::invalid_argument);
+}
+
+// Counts copies and moves to check that emplace-style inserts construct in place.
+struct CopyCounter {
+    static inline int copies = 0;
+    static inline int moves = 0;
+    int value = 0;
+
+    CopyCounter() = default;
+    explicit CopyCounter(int v) : value(v) {}
+    CopyCounter(const CopyCounter &other) : value(other.value) { ++copies; }
+    CopyCounter(CopyCounter &&other) noexcept : value(other.value) { ++moves; }
+    CopyCounter& operator=(const CopyCounter &other) { value = other.value; ++copies; return *this; }
+    CopyCounter& operator=(CopyCounter &&other) noexcept { value = other.value; ++moves; return *this; }
+};
+
+TEMPLATE_TEST_CASE("Emplace, try_emplace and insert_or_assign", "[HashMap][FlatHashMap]",
+                   (HashMap<std::string, CopyCounter, mgc::string_hash>),
+                   (FlatHashMap<std::string, CopyCounter, mgc::string_hash>)) {
+    TestType map;
+    CopyCounter::copies = CopyCounter::moves = 0;
+
+    auto [it, inserted] = map.try_emplace(std::string("a"), 1);
+    REQUIRE(inserted);
+    REQUIRE(it->second.value == 1);
+    REQUIRE(CopyCounter::copies == 0);
+    REQUIRE(CopyCounter::moves == 0);
+
+    // An existing key leaves the value and the arguments untouched.
+    std::string key = "a";
+    auto [it2, inserted2] = map.try_emplace(std::move(key), 2);
+    REQUIRE_FALSE(inserted2);
+    REQUIRE(it2->second.value == 1);
+    REQUIRE(key == "a");
+
+    // Heterogeneous try_emplace only builds the std::string key on insertion.
+    auto [it3, inserted3] = map.try_emplace(std::string_view("b"), 3);
+    REQUIRE(inserted3);
+    REQUIRE(it3->first == "b");
+
+    auto [it4, inserted4] = map.emplace("c", CopyCounter(4));
+    REQUIRE(inserted4);
+    REQUIRE(it4->second.value == 4);
+    REQUIRE(CopyCounter::copies == 0);
+    REQUIRE_FALSE(map.emplace("c", CopyCounter(5)).second);
+    REQUIRE(map.find("c")->second.value == 4);
+
+    auto [it5, inserted5] = map.insert_or_assign("a", CopyCounter(6));
+    REQUIRE_FALSE(inserted5);
+    REQUIRE(it5->second.value == 6);
+    REQUIRE(map.insert_or_assign(std::string("d"), CopyCounter(7)).second);
+
+    map.insert(std::string("e"), CopyCounter(8));
+    map[std::string("f")].value = 9;
+    REQUIRE(CopyCounter::copies == 0);
+    REQUIRE(map.size() == 6);
+    REQUIRE(map.find("e")->second.value == 8);
+    REQUIRE(map.find("f")->second.value == 9);
+}
+
+TEST_CASE("Warehouse: failed registration leaves no entry", "[warehouse]") {
+    mgw::warehouse wh;
+    mgw::product_components pc{10, 100, 150, "Widget", "ACME", "USA", "retail"};
+    // Allowance above 100 makes the retail_product constructor throw.
+    REQUIRE_THROWS_AS(wh.register_product("R1", pc), std::invalid_argument);
+    REQUIRE_THROWS_AS(wh.sell_product("R1", 1), std::invalid_argument);
+    pc.num = 20;
+    REQUIRE_NOTHROW(wh.register_product("R1", pc));
+    REQUIRE(wh.sell_product("R1", 1) == 20);
+}
+
+TEMPLATE_TEST_CASE("Bucket policies", "[HashMap]",
+                   mgc::modulo_policy, mgc::prime_modulo_policy, mgc::pow2_mask_policy, mgc::fastrange_policy) {
+    // Sequential integers hash to themselves with std::hash; every policy must still spread them.
+    HashMap<int, int, std::hash<int>, TestType> map(1, 1.0);
+    for (int i = 0; i < 5000; ++i)
+        map.insert(i * 64, i);
+    REQUIRE(map.size() == 5000);
+    REQUIRE(map.load_factor() <= 1.0);
+    for (int i = 0; i < 5000; ++i)
+        REQUIRE(map.find(i * 64)->second == i);
+
+    map.set_incremental_rehash(true);
+    for (int i = 5000; i < 20000; ++i)
+        map.insert(i * 64, i);
+    for (int i = 0; i < 20000; i += 7)
+        REQUIRE(map.find(i * 64)->second == i);
+
+    map.rehash(100);
+    REQUIRE(map.find(64)->second == 1);
+}
+
+TEST_CASE("Bucket policy capacities", "[HashMap]") {
+    REQUIRE(mgc::prime_modulo_policy::round_capacity(50) == 53);
+    REQUIRE(mgc::prime_modulo_policy::next_capacity(53) == 107);
+    REQUIRE(mgc::pow2_mask_policy::round_capacity(50) == 64);
+    REQUIRE(mgc::pow2_mask_policy::index(12345, 64) < 64);
+    REQUIRE(mgc::fastrange_policy::index(~size_t{0}, 7) < 7);
+}
+
+TEST_CASE("Seeded hashes", "[HashMap]") {
+    mgc::seeded_string_hash a(1), b(2);
+    REQUIRE(a("CIPHER-1") == a(std::string("CIPHER-1")));
+    REQUIRE(a("CIPHER-1") == a(std::string_view("CIPHER-1")));
+    REQUIRE(a("CIPHER-1") != b("CIPHER-1"));
+    REQUIRE(a("CIPHER-1") != a("CIPHER-2"));
+    REQUIRE(a("a-cipher-longer-than-eight-bytes") != a("a-cipher-longer-than-eight-bytez"));
+
+    HashMap<std::string, int, mgc::seeded_string_hash, mgc::pow2_mask_policy> map(16, 1.0, mgc::seeded_string_hash(42));
+    for (int i = 0; i < 1000; ++i)
+        map.insert("C" + std::to_string(i), i);
+    REQUIRE(map.find(std::string_view("C999"))->second == 999);
+
+    HashMap<int, int, mgc::seeded_hash<std::hash<int>>> ints;
+    ints.insert(5, 50);
+    REQUIRE(ints.find(5)->second == 50);
+}
+
+#include "../container/concurrent_hash_map.hpp"
+#include <atomic>
+#include <thread>
+
+TEMPLATE_TEST_CASE("ConcurrentHashMap: single-threaded interface", "[ConcurrentHashMap]",
+                   (mgc::ConcurrentHashMap<std::string, int, mgc::string_hash>),
+                   (mgc::ConcurrentHashMap<std::string, int, mgc::string_hash, mgc::FlatHashMap>)) {
+    TestType map(8);
+    REQUIRE(map.shards_count() == 8);
+    REQUIRE(map.insert("a", 1));
+    REQUIRE_FALSE(map.insert("a", 2));
+    REQUIRE(map.find("a") == 2);
+    REQUIRE(map.try_emplace(std::string_view("b"), 3));
+    REQUIRE_FALSE(map.try_emplace(std::string("b"), 4));
+    REQUIRE(map.find(std::string_view("b")) == 3);
+    REQUIRE_FALSE(map.find("c").has_value());
+
+    REQUIRE(map.visit("a", [](auto &kv) { kv.second += 10; }));
+    REQUIRE_FALSE(map.visit("c", [](auto &) {}));
+    int seen = 0;
+    REQUIRE(map.cvisit("a", [&seen](const auto &kv) { seen = kv.second; }));
+    REQUIRE(seen == 12);
+
+    REQUIRE_FALSE(map.try_emplace_or_visit("a", [](auto &kv) { ++kv.second; }, 0));
+    REQUIRE(map.find("a") == 13);
+
+    REQUIRE(map.size() == 2);
+    REQUIRE(map.erase("a"));
+    REQUIRE_FALSE(map.erase("a"));
+    REQUIRE_FALSE(map.contains("a"));
+    map.clear();
+    REQUIRE(map.size() == 0);
+}
+
+TEST_CASE("ConcurrentHashMap: concurrent writers and readers", "[ConcurrentHashMap]") {
+    mgc::ConcurrentHashMap<int, long> map(16);
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 5000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&map, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                map.insert(t * kPerThread + i, 1);
+                // Every thread also bumps a shared hot set of counters.
+                map.try_emplace_or_visit(-(i % 64) - 1, [](auto &kv) { ++kv.second; }, 1);
+                map.find(i);
+            }
+        });
+    }
+    for (auto &th : threads)
+        th.join();
+
+    REQUIRE(map.size() == kThreads * kPerThread + 64);
+    long hot = 0;
+    map.for_each([&hot](const auto &kv) {
+        if (kv.first < 0)
+            hot += kv.second;
+    });
+    REQUIRE(hot == kThreads * kPerThread);
+
+    std::atomic<long> total{0};
+    map.parallel_for_each([&total](const auto &kv) { total += kv.second; });
+    REQUIRE(total == 2L * kThreads * kPerThread);
+}
+
+#include "../container/rcu_hash_map.hpp"
+
+TEST_CASE("RcuHashMap: basic operations", "[RcuHashMap]") {
+    mgc::RcuHashMap<std::string, int, mgc::string_hash> map(2);
+    REQUIRE(map.insert("a", 1));
+    REQUIRE_FALSE(map.insert("a", 2));
+    REQUIRE(map.find("a") == 2);
+    REQUIRE(map.find(std::string_view("a")) == 2);
+    for (int i = 0; i < 100; ++i)
+        map.insert(std::to_string(i), i);
+    REQUIRE(map.size() == 101);
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(map.find(std::to_string(i)) == i);
+
+    int seen = 0;
+    REQUIRE(map.visit("42", [&seen](const auto &kv) { seen = kv.second; }));
+    REQUIRE(seen == 42);
+    REQUIRE_FALSE(map.contains("missing"));
+
+    REQUIRE(map.erase("a"));
+    REQUIRE_FALSE(map.erase("a"));
+    REQUIRE_FALSE(map.find("a").has_value());
+    REQUIRE(map.size() == 100);
+
+    map.clear();
+    REQUIRE(map.size() == 0);
+    REQUIRE_FALSE(map.contains("1"));
+    map.reclaim();
+    map.reclaim();
+    REQUIRE(map.pending_reclamation() == 0);
+}
+
+TEST_CASE("RcuHashMap: readers during writes and growth", "[RcuHashMap]") {
+    // Values are always key * 3 or key * 3 + 1, so a reader seeing anything else
+    // has read a torn or freed node.
+    mgc::RcuHashMap<int, long> map(1);
+    constexpr int kKeys = 2000;
+    std::atomic<bool> done{false};
+    std::atomic<long> bad{0}, hits{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                for (int k = 0; k < kKeys; k += 7) {
+                    if (auto v = map.find(k)) {
+                        ++hits;
+                        if (*v != k * 3L && *v != k * 3L + 1)
+                            ++bad;
+                    }
+                }
+            }
+        });
+    }
+
+    for (int round = 0; round < 5; ++round) {
+        for (int k = 0; k < kKeys; ++k)
+            map.insert(k, k * 3L);
+        for (int k = 0; k < kKeys; k += 2)
+            map.insert(k, k * 3L + 1);
+        for (int k = 0; k < kKeys; k += 3)
+            map.erase(k);
+        if (round % 2)
+            map.clear();
+    }
+    done = true;
+    for (auto &th : readers)
+        th.join();
+
+    REQUIRE(bad == 0);
+    REQUIRE(map.size() == static_cast<size_t>(kKeys - (kKeys + 2) / 3));
+    map.reclaim();
+    map.reclaim();
+    REQUIRE(map.pending_reclamation() == 0);
+}
+
+TEMPLATE_TEST_CASE("reserve, range construction and shrink_to_fit", "[HashMap][FlatHashMap]",
+                   (HashMap<int, int>), (mgc::FlatHashMap<int, int>)) {
+    SECTION("reserve sizes the table once") {
+        TestType map;
+        map.reserve(1000);
+        size_t buckets = map.bucket_count();
+        for (int i = 0; i < 1000; ++i)
+            map.insert(i, i);
+        REQUIRE(map.bucket_count() == buckets);
+        map.reserve(10);
+        REQUIRE(map.bucket_count() == buckets);
+    }
+
+    SECTION("range and initializer list constructors") {
+        std::vector<std::pair<int, int>> items;
+        for (int i = 0; i < 500; ++i)
+            items.emplace_back(i, i * 2);
+        items.emplace_back(7, -1);
+        TestType map(items.begin(), items.end());
+        REQUIRE(map.size() == 500);
+        REQUIRE(map.find(7)->second == -1);
+        REQUIRE(map.find(499)->second == 998);
+        REQUIRE(map.load_factor() <= 1.0);
+
+        TestType small{{1, 10}, {2, 20}, {3, 30}};
+        REQUIRE(small.size() == 3);
+        REQUIRE(small.find(2)->second == 20);
+    }
+
+    SECTION("rehash never goes below the element count and shrink_to_fit gives memory back") {
+        TestType map;
+        for (int i = 0; i < 5000; ++i)
+            map.insert(i, i);
+        map.rehash(1);
+        REQUIRE(map.load_factor() <= 1.0);
+        size_t grown = map.bucket_count();
+        for (int i = 10; i < 5000; ++i)
+            map.erase(i);
+        map.shrink_to_fit();
+        REQUIRE(map.bucket_count() < grown);
+        REQUIRE(map.size() == 10);
+        for (int i = 0; i < 10; ++i)
+            REQUIRE(map.find(i)->second == i);
+        map.insert(42, 42);
+        REQUIRE(map.find(42)->second == 42);
+    }
+}
+
+TEST_CASE("HashMap: shrink_to_fit returns node slabs", "[HashMap]") {
+    AllocStats stats;
+    {
+        HashMap<int, int, std::hash<int>, mgc::modulo_policy, CountingAllocator<std::pair<const int, int>>>
+            map(11, 1.0, CountingAllocator<std::pair<const int, int>>(&stats));
+        for (int i = 0; i < 10000; ++i)
+            map.insert(i, i);
+        size_t peak = stats.live;
+        for (int i = 5; i < 10000; ++i)
+            map.erase(i);
+        map.shrink_to_fit();
+        // The five remaining nodes were moved into a single fresh slab (plus the arena record that owns it).
+        REQUIRE(peak > 5);
+        REQUIRE(stats.live == 2);
+        for (int i = 0; i < 5; ++i)
+            REQUIRE(map.find(i)->second == i);
+    }
+    REQUIRE(stats.live == 0);
+}
+
+TEST_CASE("HashMap: a throwing shrink_to_fit leaves the map unchanged", "[HashMap]") {
+    HashMap<std::string, throwing_copy> map;
+    for (int i = 0; i < 100; ++i)
+        map.try_emplace("a key longer than the small string buffer " + std::to_string(i), i);
+    throwing_copy::countdown = 7;
+    REQUIRE_THROWS_AS(map.shrink_to_fit(), std::runtime_error);
+    throwing_copy::countdown = 0;
+    REQUIRE(map.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+        auto it = map.find("a key longer than the small string buffer " + std::to_string(i));
+        REQUIRE(it != map.end());
+        REQUIRE(it->second.v == i);
+    }
+    map.shrink_to_fit();
+    REQUIRE(map.size() == 100);
+    REQUIRE(map.find("a key longer than the small string buffer 99")->second.v == 99);
+}
+
+namespace {
+
+struct ProbeKey {
+    std::string s;
+    static inline size_t compares = 0;
+    bool operator==(const ProbeKey &other) const {
+        ++compares;
+        return s == other.s;
+    }
+};
+
+struct ProbeHash {
+    static inline size_t calls = 0;
+    size_t operator()(const ProbeKey &k) const {
+        ++calls;
+        return std::hash<std::string>{}(k.s);
+    }
+};
+
+}
+
+TEST_CASE("HashMap: cached hashes", "[HashMap]") {
+    STATIC_REQUIRE(mgc::cache_hash<std::string, mgc::string_hash>::value);
+    STATIC_REQUIRE_FALSE(mgc::cache_hash<int, std::hash<int>>::value);
+
+    // One bucket and a huge load factor put every key in the same chain.
+    HashMap<ProbeKey, int, ProbeHash> map(1, 1000.0);
+    for (int i = 0; i < 200; ++i)
+        map.insert(ProbeKey{"cipher-" + std::to_string(i)}, i);
+
+    SECTION("rehashing does not call the hasher") {
+        ProbeHash::calls = 0;
+        map.rehash(401);
+        map.set_incremental_rehash(true);
+        map.rehash(17);
+        REQUIRE(ProbeHash::calls == 0);
+        HashMap<ProbeKey, int, ProbeHash> copy(map);
+        REQUIRE(ProbeHash::calls == 0);
+        REQUIRE(copy.find(ProbeKey{"cipher-5"})->second == 5);
+    }
+
+    SECTION("a miss compares no keys") {
+        ProbeKey::compares = 0;
+        REQUIRE_FALSE(map.contains(ProbeKey{"absent"}));
+        REQUIRE(ProbeKey::compares == 0);
+        REQUIRE(map.find(ProbeKey{"cipher-199"})->second == 199);
+        REQUIRE(ProbeKey::compares == 1);
+    }
+}
+
+TEMPLATE_TEST_CASE("Batched lookup", "[HashMap][FlatHashMap]",
+                   (HashMap<std::string, int, mgc::string_hash>),
+                   (FlatHashMap<std::string, int, mgc::string_hash>)) {
+    TestType map;
+    for (int i = 0; i < 100; ++i)
+        map.insert("K" + std::to_string(i), i);
+
+    std::vector<std::string> owned;
+    for (int i = 0; i < 150; i += 3)
+        owned.push_back("K" + std::to_string(i));
+    std::vector<std::string_view> keys(owned.begin(), owned.end());
+
+    std::vector<int> seen(keys.size(), -1);
+    map.visit_many(keys, [&](size_t i, auto it) {
+        if (it != map.end())
+            seen[i] = it->second;
+    });
+    for (size_t i = 0; i < keys.size(); ++i)
+        REQUIRE(seen[i] == (i * 3 < 100 ? static_cast<int>(i * 3) : -1));
+
+    std::vector<typename TestType::iterator> found;
+    map.find_many(owned, std::back_inserter(found));
+    REQUIRE(found.size() == owned.size());
+    REQUIRE(found[1]->second == 3);
+    REQUIRE(found.back() == map.end());
+
+    const TestType &cmap = map;
+    size_t hits = 0;
+    cmap.visit_many(keys, [&](size_t, auto it) { hits += it != cmap.end(); });
+    REQUIRE(hits == 34);
+}
+
+TEST_CASE("Warehouse: batched sales", "[warehouse]") {
+    mgw::warehouse wh, reference;
+    for (int i = 0; i < 50; ++i) {
+        mgw::product_components pc{100, 100, 20, "Item" + std::to_string(i), "ACME", "USA",
+                                   i % 2 ? "retail" : "wholesale"};
+        wh.register_product("C" + std::to_string(i), pc);
+        reference.register_product("C" + std::to_string(i), pc);
+    }
+
+    std::vector<std::string> ciphers;
+    for (int i = 0; i < 50; ++i)
+        ciphers.push_back("C" + std::to_string((i * 7) % 50));
+    std::vector<mgw::order> orders;
+    size_t expected = 0;
+    for (size_t i = 0; i < ciphers.size(); ++i) {
+        orders.push_back({ciphers[i], i % 3 + 1});
+        expected += reference.sell_product(ciphers[i], i % 3 + 1);
+    }
+    REQUIRE(wh.sell_products(orders) == expected);
+    REQUIRE(wh.get_report() == reference.get_report());
+
+    std::vector<mgw::order> bad{{"C1", 1}, {"missing", 1}, {"C2", 1}};
+    REQUIRE_THROWS_AS(wh.sell_products(bad), std::invalid_argument);
+}
+
+#include "../container/dense_hash_map.hpp"
+
+TEMPLATE_TEST_CASE("DenseHashMap: basic operations", "[DenseHashMap]",
+                   (mgc::DenseHashMap<std::string, int, mgc::string_hash>),
+                   (mgc::DenseHashMap<std::string, int, mgc::string_hash, true>)) {
+    TestType map;
+    for (int i = 0; i < 1000; ++i)
+        map.insert("K" + std::to_string(i), i);
+    REQUIRE(map.size() == 1000);
+    REQUIRE(map.load_factor() <= 0.8);
+    REQUIRE(map.find(std::string_view("K500"))->second == 500);
+    REQUIRE(map.find("missing") == map.end());
+
+    // Elements are contiguous and, before any erase, in insertion order.
+    auto values = map.values();
+    REQUIRE(&*map.begin() == values.data());
+    for (size_t i = 0; i < values.size(); ++i)
+        REQUIRE(values[i].second == static_cast<int>(i));
+
+    for (int i = 0; i < 1000; i += 2)
+        map.erase("K" + std::to_string(i));
+    map.erase(std::string_view("missing"));
+    REQUIRE(map.size() == 500);
+    for (int i = 0; i < 1000; ++i)
+        REQUIRE(map.contains("K" + std::to_string(i)) == (i % 2 == 1));
+    for (const auto &kv : map)
+        REQUIRE(kv.first == "K" + std::to_string(kv.second));
+
+    auto [it, inserted] = map.try_emplace(std::string_view("new"), 7);
+    REQUIRE(inserted);
+    REQUIRE(it->first == "new");
+    REQUIRE_FALSE(map.try_emplace("new", 8).second);
+    map["new"] += 1;
+    REQUIRE(map.find("new")->second == 8);
+
+    size_t buckets = map.bucket_count();
+    map.shrink_to_fit();
+    REQUIRE(map.bucket_count() < buckets);
+    REQUIRE(map.find("K999")->second == 999);
+
+    map.clear();
+    REQUIRE(map.empty());
+    REQUIRE_FALSE(map.contains("K1"));
+}
+
+TEST_CASE("DenseHashMap: order after erase", "[DenseHashMap]") {
+    mgc::DenseHashMap<int, int, std::hash<int>, true> ordered{{1, 1}, {2, 2}, {3, 3}, {4, 4}};
+    ordered.erase(2);
+    std::vector<int> keys;
+    for (const auto &kv : ordered)
+        keys.push_back(kv.first);
+    REQUIRE(keys == std::vector<int>{1, 3, 4});
+
+    mgc::DenseHashMap<int, int> packed{{1, 1}, {2, 2}, {3, 3}, {4, 4}};
+    packed.erase(2);
+    keys.clear();
+    for (const auto &kv : packed)
+        keys.push_back(kv.first);
+    // Swap-and-pop moves the last element into the hole.
+    REQUIRE(keys == std::vector<int>{1, 4, 3});
+    REQUIRE(packed.find(4)->second == 4);
+}
+
+TEST_CASE("DenseHashMap: churn with colliding probe runs", "[DenseHashMap]") {
+    mgc::DenseHashMap<int, int> map;
+    std::vector<int> alive;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 200; ++i)
+            map.insert(round * 1000 + i, i);
+        for (int i = 0; i < 200; i += 3)
+            map.erase(round * 1000 + i);
+    }
+    size_t expected = 0;
+    for (int round = 0; round < 20; ++round)
+        for (int i = 0; i < 200; ++i) {
+            bool present = i % 3 != 0;
+            REQUIRE(map.contains(round * 1000 + i) == present);
+            expected += present;
+        }
+    REQUIRE(map.size() == expected);
+    mgc::DenseHashMap<int, int> copy(map);
+    REQUIRE(copy.size() == expected);
+    REQUIRE(copy.find(19001)->second == 1);
+}
+
+#include "../container/parallel.hpp"
+
+TEMPLATE_TEST_CASE("Parallel scans", "[HashMap][FlatHashMap][DenseHashMap]",
+                   (HashMap<int, long>), (FlatHashMap<int, long>), (mgc::DenseHashMap<int, long>)) {
+    TestType map;
+    for (int i = 0; i < 20000; ++i)
+        map.insert(i, i);
+    if constexpr (requires { map.set_incremental_rehash(true); }) {
+        // Leave a migration half done so the scan has to cover both bucket arrays.
+        map.set_incremental_rehash(true);
+        for (int i = 20000; i < 25000; ++i)
+            map.insert(i, i);
+    } else {
+        for (int i = 20000; i < 25000; ++i)
+            map.insert(i, i);
+    }
+    const long expected = 25000L * 24999 / 2;
+
+    std::atomic<long> sum{0};
+    mgc::parallel_for_each(map, [&sum](const auto &kv) { sum += kv.second; });
+    REQUIRE(sum == expected);
+
+    long reduced = mgc::parallel_reduce(map, 0L, [](const auto &kv) { return kv.second; },
+                                        [](long a, long b) { return a + b; });
+    REQUIRE(reduced == expected);
+
+    // Non-commutative reduction: partial results are joined in position order.
+    std::vector<int> serial;
+    map.for_each_in(0, map.scan_extent(), [&serial](const auto &kv) { serial.push_back(kv.first); });
+    REQUIRE(serial.size() == 25000);
+    auto joined = mgc::parallel_reduce(map, std::vector<int>(),
+        [](const auto &kv) { return std::vector<int>{kv.first}; },
+        [](std::vector<int> a, std::vector<int> b) { a.insert(a.end(), b.begin(), b.end()); return a; });
+    REQUIRE(joined == serial);
+
+    TestType empty;
+    REQUIRE(mgc::parallel_reduce(empty, 0L, [](const auto &kv) { return kv.second; },
+                                 [](long a, long b) { return a + b; }) == 0);
+}
+
+TEST_CASE("Warehouse: missing products", "[warehouse]") {
+    mgw::warehouse wh;
+    for (int i = 0; i < 3000; ++i) {
+        mgw::product_components pc{10, 100, 20, "Item" + std::to_string(i), "ACME", "USA", "retail"};
+        wh.register_product("C" + std::to_string(i), pc);
+    }
+    for (int i = 0; i < 3000; i += 100)
+        wh.sell_product("C" + std::to_string(i), 10);
+
+    std::string missing = wh.missing_products();
+    REQUIRE(std::count(missing.begin(), missing.end(), '\n') == 30);
+    REQUIRE(missing.find("Item100\n") != std::string::npos);
+    REQUIRE(missing.find("Item101\n") == std::string::npos);
+}
+
+TEST_CASE("HashMap: node handles and merge", "[HashMap]") {
+    using Map = HashMap<std::string, int, mgc::string_hash>;
+
+    SECTION("extract and insert relink the same node") {
+        Map a, b;
+        a.insert("x", 1);
+        a.insert("y", 2);
+        const int* addr = &a.find("x")->second;
+
+        Map::node_type nh = a.extract("x");
+        REQUIRE(nh);
+        REQUIRE(nh.key() == "x");
+        nh.mapped() = 10;
+        REQUIRE_FALSE(a.contains("x"));
+        REQUIRE(a.size() == 1);
+        REQUIRE(a.extract("missing").empty());
+
+        auto res = b.insert(std::move(nh));
+        REQUIRE(res.inserted);
+        REQUIRE(res.node.empty());
+        REQUIRE(&res.position->second == addr);
+        REQUIRE(b.find("x")->second == 10);
+
+        // A duplicate key hands the node back.
+        b.insert("y", 5);
+        auto dup = b.insert(a.extract(a.find("y")));
+        REQUIRE_FALSE(dup.inserted);
+        REQUIRE(dup.node.key() == "y");
+        REQUIRE(dup.position->second == 5);
+        REQUIRE(a.size() == 0);
+    }
+
+    SECTION("nodes outlive the map they came from") {
+        Map b;
+        Map::node_type kept;
+        {
+            Map a;
+            for (int i = 0; i < 100; ++i)
+                a.insert("k" + std::to_string(i), i);
+            kept = a.extract("k7");
+            b.insert(a.extract("k8"));
+            a.clear();
+            a.insert("fresh", 1);
+        }
+        REQUIRE(kept.mapped() == 7);
+        b.insert(std::move(kept));
+        REQUIRE(b.find("k7")->second == 7);
+        REQUIRE(b.find("k8")->second == 8);
+        b.erase("k7");
+        b.insert("k9", 9);
+        REQUIRE(b.size() == 2);
+    }
+
+    SECTION("merge moves only missing keys, without allocating nodes") {
+        AllocStats stats;
+        using Alloc = CountingAllocator<std::pair<const int, int>>;
+        using IntMap = HashMap<int, int, std::hash<int>, mgc::modulo_policy, Alloc>;
+        IntMap dst(11, 1.0, Alloc(&stats)), src(11, 1.0, Alloc(&stats));
+        for (int i = 0; i < 1000; ++i)
+            src.insert(i, i);
+        for (int i = 0; i < 10; ++i)
+            dst.insert(i, -i);
+        const int* addr = &src.find(500)->second;
+
+        size_t before = stats.allocations;
+        dst.merge(src);
+        // Only the list recording src's arena is allocated, never a node.
+        REQUIRE(stats.allocations - before <= 2);
+        REQUIRE(dst.size() == 1000);
+        REQUIRE(src.size() == 10);
+        REQUIRE(dst.find(3)->second == -3);
+        REQUIRE(src.find(3)->second == 3);
+        REQUIRE(&dst.find(500)->second == addr);
+
+        src.clear();
+        for (int i = 0; i < 1000; ++i)
+            REQUIRE(dst.find(i)->second == (i < 10 ? -i : i));
+    }
+}
+
+#include "../container/lru_cache.hpp"
+
+TEST_CASE("HashMap: touch and erase by iterator", "[HashMap]") {
+    HashMap<int, int> map;
+    for (int i = 0; i < 5; ++i)
+        map.insert(i, i);
+    map.touch(map.find(0));
+    map.touch(map.find(3));
+    map.touch(map.find(3));
+    std::vector<int> order;
+    for (const auto &kv : map)
+        order.push_back(kv.first);
+    REQUIRE(order == std::vector<int>{1, 2, 4, 0, 3});
+    REQUIRE((--map.end())->first == 3);
+
+    auto next = map.erase(map.find(2));
+    REQUIRE(next->first == 4);
+    REQUIRE(map.erase(map.find(3)) == map.end());
+    REQUIRE(map.size() == 3);
+    REQUIRE_FALSE(map.contains(2));
+}
+
+TEST_CASE("LruCache", "[LruCache]") {
+    SECTION("entry bound evicts the least recently used") {
+        std::vector<std::string> evicted;
+        mgc::LruCache<std::string, int, mgc::string_hash> cache(
+            3, mgc::LruCache<std::string, int, mgc::string_hash>::kUnbounded, nullptr,
+            [&evicted](const std::string &k, int &) { evicted.push_back(k); });
+        cache.put("a", 1);
+        cache.put("b", 2);
+        cache.put("c", 3);
+        REQUIRE(*cache.get(std::string_view("a")) == 1); // a is now most recent
+        cache.put("d", 4);
+        REQUIRE(evicted == std::vector<std::string>{"b"});
+        REQUIRE(cache.peek("c") != nullptr);
+        cache.put("e", 5);                               // peek did not refresh c
+        REQUIRE(evicted == std::vector<std::string>{"b", "c"});
+        REQUIRE(cache.get("b") == nullptr);
+        REQUIRE(cache.size() == 3);
+
+        cache.put("a", 10);                              // update keeps one entry
+        REQUIRE(cache.size() == 3);
+        REQUIRE(*cache.get("a") == 10);
+        cache.set_limits(1);
+        REQUIRE(cache.size() == 1);
+        REQUIRE(cache.contains("a"));
+    }
+
+    SECTION("byte budget") {
+        size_t evictions = 0;
+        mgc::LruCache<int, std::string> cache(
+            mgc::LruCache<int, std::string>::kUnbounded, 100,
+            [](const int &, const std::string &v) { return v.size(); },
+            [&evictions](const int &, std::string &) { ++evictions; });
+        cache.put(1, std::string(40, 'x'));
+        cache.put(2, std::string(40, 'y'));
+        REQUIRE(cache.weight() == 80);
+        cache.put(3, std::string(40, 'z'));
+        REQUIRE(evictions == 1);
+        REQUIRE_FALSE(cache.contains(1));
+        REQUIRE(cache.weight() == 80);
+        cache.put(2, std::string(10, 'y'));
+        REQUIRE(cache.weight() == 50);
+        cache.put(4, std::string(500, 'w'));             // heavier than the budget on its own
+        REQUIRE_FALSE(cache.contains(4));
+        REQUIRE(cache.weight() == 0);
+        cache.put(5, "v");
+        cache.erase(5);
+        REQUIRE(cache.weight() == 0);
+    }
+
+    SECTION("weight is charged once, when stored") {
+        mgc::LruCache<int, std::string> cache(
+            mgc::LruCache<int, std::string>::kUnbounded, 100,
+            [](const int &, const std::string &v) { return v.size(); });
+        cache.put(1, std::string(10, 'x'));
+        cache.put(2, std::string(20, 'y'));
+        cache.get(1)->assign(60, 'x');                   // grows after being charged
+        REQUIRE(cache.weight() == 30);
+        cache.erase(1);
+        REQUIRE(cache.weight() == 20);
+        cache.get(2)->clear();                           // shrinks after being charged
+        cache.put(2, std::string(5, 'y'));
+        REQUIRE(cache.weight() == 5);
+        cache.put(3, std::string(40, 'z'));
+        cache.get(3)->resize(1);                         // charged 40, now weighs 1
+        cache.put(4, std::string(60, 'w'));              // 105: evicts 2
+        REQUIRE(cache.weight() == 100);
+        cache.put(5, "v");                               // 101: evicts 3 by its stored 40
+        REQUIRE(cache.weight() == 61);
+        std::vector<int> keys;
+        cache.for_each([&keys](const int &k, const std::string &) { keys.push_back(k); });
+        REQUIRE(keys == std::vector<int>{4, 5});
+    }
+}
+
+#include "../container/fixed_key.hpp"
+
+TEST_CASE("fixed_key", "[fixed_key]") {
+    using key = mgc::fixed_key<32>;
+    key a("R-77"), b(std::string("R-77")), c("R-78"), empty;
+    REQUIRE(a == b);
+    REQUIRE_FALSE(a == c);
+    REQUIRE(a.view() == "R-77");
+    REQUIRE(a.size() == 4);
+    REQUIRE(empty.size() == 0);
+    REQUIRE_FALSE(empty == key(std::string_view("\0", 1)));  // the length byte tells them apart
+    REQUIRE(a == std::string_view("R-77"));
+    REQUIRE_FALSE(a == std::string_view("R-7"));
+    REQUIRE(mgc::fixed_key_hash()(a) == mgc::fixed_key_hash()(std::string_view("R-77")));
+
+    std::string longest(key::max_size, 'x');
+    REQUIRE(key(longest).view() == longest);
+    REQUIRE_FALSE(key(longest) == key(std::string(key::max_size - 1, 'x')));
+    REQUIRE_THROWS_AS(key(longest + 'x'), std::length_error);
+
+    mgc::HashMap<mgc::fixed_key<16>, int> nodes;
+    mgc::FlatHashMap<key, int, mgc::fixed_key_hash> flat;
+    for (int i = 0; i < 200; ++i) {
+        std::string s = "K-" + std::to_string(i);
+        nodes.insert(mgc::fixed_key<16>(s), i);
+        flat.try_emplace(std::string_view(s), i);
+    }
+    REQUIRE(nodes.size() == 200);
+    REQUIRE(flat.size() == 200);
+    REQUIRE(nodes[mgc::fixed_key<16>("K-42")] == 42);
+    REQUIRE(flat.find(std::string_view("K-199"))->second == 199);
+    REQUIRE(flat.find(std::string_view("K-200")) == flat.end());
+}
+
+TEST_CASE("Warehouse: cipher length limit", "[warehouse]") {
+    mgw::warehouse wh;
+    mgw::product_components pc{10, 100, 20, "Widget", "ACME", "USA", "retail"};
+    std::string cipher(mgw::cipher_key::max_size, 'C');
+    wh.register_product(cipher, pc);
+    REQUIRE(wh.sell_product(cipher, 1) == 20);
+    REQUIRE_THROWS_AS(wh.register_product(cipher + 'C', pc), std::length_error);
+    REQUIRE_THROWS_AS(wh.sell_product(cipher + 'C', 1), std::invalid_argument);
+}
+
+#include "../container/bloom_filter.hpp"
+
+TEST_CASE("BloomFilter", "[BloomFilter]") {
+    mgc::BloomFilter filter(10000, 0.01);
+    mgc::seeded_string_hash h(42);
+    for (int i = 0; i < 10000; ++i)
+        filter.insert(h("in-" + std::to_string(i)));
+    for (int i = 0; i < 10000; ++i)
+        REQUIRE(filter.may_contain(h("in-" + std::to_string(i))));
+    size_t false_positives = 0;
+    for (int i = 0; i < 100000; ++i)
+        false_positives += filter.may_contain(h("out-" + std::to_string(i)));
+    REQUIRE(false_positives < 2000);  // target 1%; blocked filters run somewhat higher
+    REQUIRE(filter.size() == 10000);
+
+    filter.clear();
+    REQUIRE_FALSE(filter.may_contain(h("in-0")));
+    REQUIRE_THROWS_AS(mgc::BloomFilter(10, 0.0), std::invalid_argument);
+}
+
+TEST_CASE("Warehouse: cipher filter", "[warehouse]") {
+    mgw::warehouse wh;
+    mgw::product_components pc{10, 100, 20, "Widget", "ACME", "USA", "retail"};
+    for (int i = 0; i < 50; ++i)
+        wh.register_product("C-" + std::to_string(i), pc);
+    wh.enable_cipher_filter(0.01);
+    for (int i = 50; i < 300; ++i)   // grows past the initial capacity
+        wh.register_product("C-" + std::to_string(i), pc);
+    for (int i = 0; i < 300; ++i)
+        REQUIRE(wh.sell_product("C-" + std::to_string(i), 1) == 20);
+
+    for (int i = 0; i < 1000; ++i)
+        REQUIRE_THROWS_AS(wh.sell_product("X-" + std::to_string(i), 1), std::invalid_argument);
+    mgw::filter_stats stats = wh.cipher_filter_stats();
+    REQUIRE(stats.queries == 1300);
+    REQUIRE(stats.rejected + stats.false_positives == 1000);
+    REQUIRE(stats.false_positive_rate() < 0.05);
+
+    for (int i = 0; i < 300; i += 2)
+        REQUIRE(wh.remove_product("C-" + std::to_string(i)));
+    REQUIRE_FALSE(wh.remove_product("C-0"));
+    for (int i = 0; i < 300; ++i) {
+        if (i % 2)
+            REQUIRE(wh.sell_product("C-" + std::to_string(i), 1) == 20);
+        else
+            REQUIRE_THROWS_AS(wh.sell_product("C-" + std::to_string(i), 1), std::invalid_argument);
+    }
+
+    wh.reset_cipher_filter_stats();
+    wh.disable_cipher_filter();
+    REQUIRE_THROWS_AS(wh.sell_product("X-0", 1), std::invalid_argument);
+    REQUIRE(wh.cipher_filter_stats().queries == 0);
+}
+
+TEST_CASE("Warehouse: batched sales go through the cipher filter", "[warehouse]") {
+    mgw::warehouse wh;
+    mgw::product_components pc{1000, 100, 20, "Widget", "ACME", "USA", "retail"};
+    for (int i = 0; i < 100; ++i)
+        wh.register_product("C-" + std::to_string(i), pc);
+    wh.enable_cipher_filter(0.01);
+
+    std::vector<std::string> ciphers;
+    for (int i = 0; i < 100; ++i)
+        ciphers.push_back("C-" + std::to_string(i));
+    std::vector<mgw::order> orders;
+    for (const std::string &c : ciphers)
+        orders.push_back({c, 1});
+    REQUIRE(wh.sell_products(orders) == 100 * 20);
+    REQUIRE(wh.cipher_filter_stats().queries == 100);
+
+    size_t failed = 0;
+    for (int i = 0; i < 200; ++i) {
+        std::string unknown = "X-" + std::to_string(i);
+        std::vector<mgw::order> batch{{"C-0", 1}, {unknown, 1}, {"C-1", 1}};
+        REQUIRE_THROWS_AS(wh.sell_products(batch), std::invalid_argument);
+        ++failed;
+    }
+    mgw::filter_stats stats = wh.cipher_filter_stats();
+    REQUIRE(stats.queries == 100 + 2 * failed);   // the order after the unknown one is not reached
+    REQUIRE(stats.rejected + stats.false_positives == failed);
+    REQUIRE(stats.rejected > failed / 2);
+    // Only the order before the unknown cipher was sold from each failed batch.
+    REQUIRE(wh.inventory().total_stock() == 100 * 1000 - 100 - failed);
+}
+
+TEST_CASE("Warehouse: a rejected filter rate keeps the current filter", "[warehouse]") {
+    mgw::warehouse wh;
+    mgw::product_components pc{10, 100, 20, "Widget", "ACME", "USA", "retail"};
+    wh.enable_cipher_filter(0.01);
+    REQUIRE_THROWS_AS(wh.enable_cipher_filter(2.0), std::invalid_argument);
+    for (int i = 0; i < 200; ++i)    // grows past the initial capacity, rebuilding the filter
+        REQUIRE_NOTHROW(wh.register_product("C-" + std::to_string(i), pc));
+    for (int i = 0; i < 200; i += 2)
+        REQUIRE(wh.remove_product("C-" + std::to_string(i)));
+    for (int i = 1; i < 200; i += 2)
+        REQUIRE(wh.sell_product("C-" + std::to_string(i), 1) == 20);
+    REQUIRE_THROWS_AS(wh.sell_product("C-0", 1), std::invalid_argument);
+}
+
+TEST_CASE("Warehouse: out-of-stock index", "[warehouse]") {
+    mgw::warehouse wh;
+    mgw::product_components retail{2, 100, 20, "Bolt", "ACME", "USA", "retail"};
+    mgw::product_components empty{0, 100, 20, "Nut", "ACME", "USA", "retail"};
+    wh.register_product("B", retail);
+    wh.register_product("N", empty);
+    REQUIRE(wh.missing_products() == "Nut\n");
+
+    wh.sell_product("B", 2);
+    std::string missing = wh.missing_products();
+    REQUIRE(missing.find("Bolt\n") != std::string::npos);
+    REQUIRE(missing.find("Nut\n") != std::string::npos);
+
+    REQUIRE_THROWS(wh.sell_product("B", 1));           // a failed sale changes nothing
+    wh.register_product("N", empty);                   // restocking with zero keeps it listed
+    REQUIRE(wh.missing_products().find("Nut\n") != std::string::npos);
+    wh.register_product("B", retail);                  // restocked
+    REQUIRE(wh.missing_products() == "Nut\n");
+
+    std::vector<mgw::order> orders{{"B", 1}, {"B", 1}};
+    wh.sell_products(orders);
+    REQUIRE(wh.missing_products().find("Bolt\n") != std::string::npos);
+    wh.remove_product("B");
+    wh.remove_product("N");
+    REQUIRE(wh.missing_products().empty());
+}
+
+TEST_CASE("Warehouse: streaming report", "[warehouse]") {
+    mgw::warehouse wh;
+    for (int i = 0; i < 100; ++i) {
+        mgw::product_components pc{size_t(i), 100, 5, "Item" + std::to_string(i), "ACME", "USA",
+                                   i % 2 ? "retail" : "wholesale"};
+        wh.register_product("C" + std::to_string(i), pc);
+    }
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(wh.get_report().find("[Name: Item" + std::to_string(i) + "]") != std::string::npos);
+
+    std::ostringstream os;
+    wh.write_report(os);
+    std::string buffer = "header\n";
+    wh.write_report(buffer);
+    std::vector<char> chars;
+    wh.write_report(std::back_inserter(chars));
+
+    REQUIRE(os.str() == wh.get_report());
+    REQUIRE(buffer == "header\n" + wh.get_report());
+    REQUIRE(std::string(chars.begin(), chars.end()) == wh.get_report());
+    REQUIRE(std::count(chars.begin(), chars.end(), '\n') == 100);
+
+    mgw::retail_product rp(10, 100, "Widget", "ACME", "USA", 20);
+    std::string info = "> ";
+    rp.append_Info(info);
+    REQUIRE(info == "> " + rp.get_Info());
+}
+
+#include "../logic/concurrent_warehouse.hpp"
+
+TEST_CASE("stock_counter", "[product]") {
+    STATIC_REQUIRE(sizeof(mgw::stock_counter) == 64);
+    mgw::stock_counter c(5);
+    REQUIRE(c.take(3));
+    REQUIRE_FALSE(c.take(3));
+    REQUIRE(c.load() == 2);
+    c.add(1);
+    mgw::stock_counter copy = c;
+    REQUIRE(copy.load() == 3);
+    // Only concurrent_warehouse pays for the padded counter; products keep a plain quantity.
+    STATIC_REQUIRE(alignof(mgw::retail_product) <= alignof(std::max_align_t));
+    STATIC_REQUIRE(alignof(mgw::wholesale_product) <= alignof(std::max_align_t));
+}
+
+TEST_CASE("concurrent_warehouse: contended sales never oversell", "[warehouse]") {
+    mgw::concurrent_warehouse wh(8);
+    mgw::product_components retail{1000, 100, 10, "Hot", "ACME", "USA", "retail"};
+    mgw::product_components wholesale{40, 10, 4, "Bulk", "ACME", "USA", "wholesale"};
+    wh.register_product("HOT", retail);
+    wh.register_product("BULK", wholesale);
+    REQUIRE_THROWS_AS(wh.register_product("X", {1, 1, 1, "X", "X", "X", "other"}), std::invalid_argument);
+
+    constexpr int kThreads = 8;
+    std::atomic<size_t> sold{0}, failed{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int i = 0; i < 300; ++i) {
+                try {
+                    wh.sell_product("HOT", 1);
+                    sold.fetch_add(1);
+                } catch (const std::invalid_argument &) {
+                    failed.fetch_add(1);
+                }
+                if (t == 0 && i % 10 == 0)
+                    wh.register_product("BULK", wholesale);     // restocks concurrently with sales
+                wh.register_product("NEW-" + std::to_string(i), retail);  // same new cipher from every thread
+            }
+        });
+    }
+    for (auto &w : workers)
+        w.join();
+
+    REQUIRE(sold.load() == 1000);
+    REQUIRE(failed.load() == kThreads * 300 - 1000);
+    REQUIRE(wh.get_quantity("HOT") == 0);
+    REQUIRE(wh.get_quantity("NEW-0") == 1000 * kThreads);
+    REQUIRE(wh.size() == 302);
+    REQUIRE(wh.missing_products() == "Hot\n");
+    REQUIRE(wh.sell_product("BULK", 2) == 80);
+
+    std::ostringstream os;
+    wh.write_report(os);
+    REQUIRE(os.str() == wh.get_report());
+    REQUIRE(wh.remove_product("HOT"));
+    REQUIRE_FALSE(wh.remove_product("HOT"));
+    REQUIRE_THROWS_AS(wh.sell_product("HOT", 1), std::invalid_argument);
+}
+
+#include "../logic/variant_warehouse.hpp"
+
+TEST_CASE("variant_warehouse matches warehouse", "[warehouse]") {
+    mgw::warehouse reference;
+    mgw::variant_warehouse wh;
+    REQUIRE(mgw::parse_product_kind("retail") == mgw::product_kind::retail);
+    REQUIRE_THROWS_AS(mgw::parse_product_kind("bulk"), std::invalid_argument);
+
+    for (int i = 0; i < 200; ++i) {
+        mgw::product_components pc{size_t(i % 7) * 8, 10 + size_t(i), 2, "Item" + std::to_string(i), "ACME", "USA",
+                                   i % 3 ? "retail" : "wholesale"};
+        reference.register_product("C" + std::to_string(i), pc);
+        wh.register_product("C" + std::to_string(i), pc);
+    }
+    mgw::product_components bad{1, 1, 101, "Bad", "ACME", "USA", "retail"};  // allowance over 100
+    REQUIRE_THROWS_AS(wh.register_product("BAD", bad), std::invalid_argument);
+    REQUIRE_THROWS_AS(wh.register_product("BAD", {1, 1, 1, "Bad", "ACME", "USA", "other"}), std::invalid_argument);
+    REQUIRE(wh.size() == 200);
+
+    for (int i = 0; i < 200; i += 3) {
+        std::string c = "C" + std::to_string(i);
+        size_t expected = 0;
+        bool failed = false;
+        try { expected = reference.sell_product(c, 1); } catch (const std::invalid_argument &) { failed = true; }
+        if (failed)
+            REQUIRE_THROWS_AS(wh.sell_product(c, 1), std::invalid_argument);
+        else
+            REQUIRE(wh.sell_product(c, 1) == expected);
+    }
+    std::vector<mgw::order> orders{{"C1", 1}, {"C2", 2}, {"C4", 1}};
+    REQUIRE(wh.sell_products(orders) == reference.sell_products(orders));
+    wh.register_product("C0", {5, 0, 0, "", "", "", "retail"});   // restock keeps the existing type
+    reference.register_product("C0", {5, 0, 0, "", "", "", "retail"});
+
+    for (int i = 5; i < 200; i += 17) {   // moves later products into the freed rows
+        REQUIRE(wh.remove_product("C" + std::to_string(i)));
+        REQUIRE(reference.remove_product("C" + std::to_string(i)));
+    }
+    REQUIRE_FALSE(wh.remove_product("C5"));
+    REQUIRE(wh.get_report() == reference.get_report());
+
+    // warehouse lists missing products in the order they ran out, so only the set is compared.
+    auto lines = [](const std::string &s) {
+        std::vector<std::string> out;
+        std::istringstream in(s);
+        for (std::string line; std::getline(in, line);)
+            out.push_back(line);
+        std::sort(out.begin(), out.end());
+        return out;
+    };
+    REQUIRE(lines(wh.missing_products()) == lines(reference.missing_products()));
+    std::ostringstream os;
+    wh.write_report(os);
+    REQUIRE(os.str() == wh.get_report());
+
+    size_t retail = 0, wholesale = 0;
+    wh.for_each_product([&](std::string_view, const auto &p) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(p)>, mgw::retail_product>)
+            ++retail;
+        else
+            ++wholesale;
+    });
+    REQUIRE(retail == 125);
+    REQUIRE(wholesale == 63);
+    REQUIRE(wh.remove_product("C0"));
+    REQUIRE_FALSE(wh.remove_product("C0"));
+    REQUIRE_THROWS_AS(wh.sell_product("C0", 1), std::invalid_argument);
+}
+
+TEST_CASE("inventory_columns: kernels", "[inventory]") {
+    mgw::inventory_columns cols;
+    std::mt19937_64 rng(3);
+    for (int n = 0; n < 23; ++n) {           // every tail length
+        uint64_t stock = 0, value = 0;
+        size_t below = 0;
+        for (size_t r = 0; r < cols.size(); ++r) {
+            stock += cols.quantities()[r];
+            value += cols.quantities()[r] * cols.costs()[r];
+            below += cols.quantities()[r] < (uint64_t(1) << 63);
+        }
+        REQUIRE(cols.total_stock() == stock);
+        REQUIRE(cols.inventory_value() == value);
+        REQUIRE(cols.count_below(uint64_t(1) << 63) == below);
+        uint64_t big = rng();                // full-width values exercise the carries
+        cols.insert(mgw::cipher_key(std::to_string(n)), mgw::product_kind::retail, big, rng(), 5);
+    }
+    REQUIRE(cols.count_below(0) == 0);
+    REQUIRE(cols.count_below(~uint64_t(0)) == cols.size() - size_t(std::count(cols.quantities().begin(), cols.quantities().end(), ~uint64_t(0))));
+}
+
+TEST_CASE("Warehouse: inventory columns stay in sync", "[warehouse][inventory]") {
+    mgw::warehouse wh;
+    for (int i = 0; i < 50; ++i) {
+        mgw::product_components pc{size_t(i), size_t(10 + i), 3, "Item" + std::to_string(i), "ACME", "USA",
+                                   i % 2 ? "retail" : "wholesale"};
+        wh.register_product("C" + std::to_string(i), pc);
+    }
+    wh.sell_product("C1", 1);                                      // retail: 1 unit
+    wh.sell_product("C4", 1);                                      // wholesale: 3 units
+    wh.register_product("C0", {6, 0, 0, "", "", "", "wholesale"}); // restock 6 batches of 3
+    REQUIRE(wh.remove_product("C10"));
+    REQUIRE(wh.remove_product("C49"));
+    wh.sell_product("C48", 2);                                     // moved into C10's row by the removals
+    REQUIRE(wh.missing_products() == "Item1\n");
+
+    const mgw::inventory_columns &cols = wh.inventory();
+    REQUIRE(cols.size() == 48);
+    REQUIRE(cols.cipher(10) == "C48");
+    REQUIRE(cols.quantities()[10] == 42);
+    uint64_t stock = 0, value = 0;
+    size_t below = 0;
+    for (int i = 0; i < 50; ++i) {
+        if (i == 10 || i == 49)
+            continue;
+        uint64_t q = uint64_t(i) - (i == 1) - 3 * (i == 4) + 18 * (i == 0) - 6 * (i == 48);
+        stock += q;
+        value += q * uint64_t(10 + i);
+        below += q < 5;
+    }
+    REQUIRE(cols.total_stock() == stock);
+    REQUIRE(cols.inventory_value() == value);
+    REQUIRE(cols.count_below(5) == below);
+    for (size_t r = 0; r < cols.size(); ++r) {
+        int i = std::stoi(std::string(cols.cipher(r).substr(1)));
+        REQUIRE(cols.kind(r) == (i % 2 ? mgw::product_kind::retail : mgw::product_kind::wholesale));
+        REQUIRE(cols.allowances()[r] == (i % 2 ? 3u : 0u));
+        REQUIRE(cols.wholesale_sizes()[r] == (i % 2 ? 0u : 3u));
+    }
+}
+
+#include "../container/string_pool.hpp"
+
+TEST_CASE("StringPool", "[StringPool]") {
+    mgc::StringPool pool;
+    std::string acme = "ACME";
+    mgc::InternedString a = pool.intern(acme), b = pool.intern(std::string_view("ACME")), c = pool.intern("Initech");
+    REQUIRE(a == b);
+    REQUIRE_FALSE(a == c);
+    REQUIRE(a.view() == "ACME");
+    REQUIRE(a.view().data() == b.view().data());
+    REQUIRE(a.id() == 1);
+    REQUIRE(c.id() == 2);
+    REQUIRE(pool.intern("") == mgc::InternedString());
+    REQUIRE(mgc::InternedString().id() == 0);
+    REQUIRE(pool.size() == 3);
+    STATIC_REQUIRE(sizeof(mgc::InternedString) == sizeof(void*));
+
+    std::vector<std::thread> workers;
+    std::vector<std::vector<mgc::InternedString>> seen(4);
+    for (int t = 0; t < 4; ++t)
+        workers.emplace_back([&pool, &seen, t] {
+            for (int i = 0; i < 500; ++i)
+                seen[size_t(t)].push_back(pool.intern("firm-" + std::to_string(i % 50)));
+        });
+    for (auto &w : workers)
+        w.join();
+    REQUIRE(pool.size() == 53);
+    for (int t = 1; t < 4; ++t)
+        REQUIRE(seen[size_t(t)] == seen[0]);
+}
+
+TEST_CASE("Products share interned firm and country", "[product]") {
+    mgw::retail_product a(1, 1, "A", "ACME", "USA", 5);
+    mgw::wholesale_product b(1, 1, "B", std::string("ACME"), "Canada", 2);
+    REQUIRE(a.get_firm() == b.get_firm());
+    REQUIRE_FALSE(a.get_country() == b.get_country());
+    REQUIRE(a.get_type() == "retail");
+    REQUIRE(b.change_to_retail(3).get_firm() == a.get_firm());
+}
+
+#include <memory_resource>
+
+TEST_CASE("Warehouse: products in a memory resource", "[warehouse]") {
+    // Counts what goes through the arena; names longer than the small-string buffer must land there.
+    struct counting_resource : std::pmr::memory_resource {
+        std::pmr::monotonic_buffer_resource arena;
+        size_t allocations = 0;
+        void* do_allocate(size_t bytes, size_t align) override { ++allocations; return arena.allocate(bytes, align); }
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+    } mr;
+
+    {
+        mgw::warehouse wh(&mr);
+        REQUIRE(wh.get_memory_resource() == &mr);
+        for (int i = 0; i < 100; ++i) {
+            mgw::product_components pc{5, 10, 2, "A product name well past the SSO limit " + std::to_string(i),
+                                       "ACME", "USA", i % 2 ? "retail" : "wholesale"};
+            wh.register_product("P" + std::to_string(i), pc);
+        }
+        REQUIRE(mr.allocations == 200);       // one control block + product, one name each
+        REQUIRE(wh.sell_product("P1", 1) == 0);
+        REQUIRE(wh.get_report().find("name well past the SSO limit 42") != std::string::npos);
+    }
+
+    auto p = mgw::make_product({1, 1, 1, "A product name well past the SSO limit", "F", "C", "retail"}, &mr);
+    REQUIRE(p->get_allocator().resource() == &mr);
+    REQUIRE(mr.allocations == 202);
+    mgw::retail_product copy(1, 1, "x", "F", "C", 1);
+    REQUIRE(copy.get_allocator().resource() == std::pmr::get_default_resource());
+}
+
+TEST_CASE("Warehouse: reserve", "[warehouse]") {
+    mgw::warehouse wh;
+    wh.enable_cipher_filter();
+    wh.reserve(500);
+    for (int i = 0; i < 500; ++i)
+        wh.register_product("R" + std::to_string(i), {3, 10, 1, "Item", "ACME", "USA", i % 2 ? "retail" : "wholesale"});
+    wh.reserve(10); // smaller than the catalog: nothing changes
+    REQUIRE(wh.inventory().size() == 500);
+    REQUIRE(wh.inventory().total_stock() == 1500);
+    for (int i = 0; i < 500; ++i)
+        wh.sell_product("R" + std::to_string(i), 1);
+    REQUIRE(wh.inventory().total_stock() == 1000);
+    REQUIRE_THROWS_AS(wh.sell_product("missing", 1), std::invalid_argument);
+    REQUIRE(wh.cipher_filter_stats().queries == 501);
+}
+
+TEST_CASE("Warehouse: report order", "[warehouse]") {
+    mgw::warehouse wh;
+    for (int i = 0; i < 5; ++i)
+        wh.register_product("C" + std::to_string(i), {1, 1, 1, "Item" + std::to_string(i), "ACME", "USA", "retail"});
+    auto names = [&wh] {
+        std::string out;
+        std::istringstream in(wh.get_report());
+        for (std::string line; std::getline(in, line);)
+            out += line.substr(7, 5);   // "[Name: ItemN]"
+        return out;
+    };
+    REQUIRE(names() == "Item0Item1Item2Item3Item4");
+    REQUIRE(wh.remove_product("C1"));   // the last product takes the freed place
+    wh.register_product("C5", {1, 1, 1, "Item5", "ACME", "USA", "retail"});
+    wh.register_product("C2", {1, 1, 1, "", "", "", "retail"});   // restocking keeps the place
+    REQUIRE(names() == "Item0Item4Item2Item3Item5");
+    std::string buffer;
+    wh.write_report(buffer);
+    REQUIRE(buffer == wh.get_report());
+}